@@ -6,20 +6,55 @@ void set_defaults(conv_config_t* restrict conv_conf)
     memset(conv_conf->input_info, '\0', sizeof(input_info_t) * MAXMIN_INPUT_COUNT);
 
     conv_conf->total_samples    = 0;
+    conv_conf->columns          = 0;
     conv_conf->precision        = 6;
 
+    conv_conf->stats.peak   = 0.0;
+    conv_conf->stats.energy = 0.0;
+    conv_conf->scale        = 1.0;
+    conv_conf->norm_bound   = 0.0;
+
+    conv_conf->batch_info   = NULL;
+    conv_conf->batch_count  = 0;
+    conv_conf->batch_index  = H_INDEX;
+
+    conv_conf->block_size   = 0;
+    conv_conf->threads      = 0;
+    conv_conf->mem_limit    = 0;
+
+    memset(&conv_conf->schedule, 0, sizeof(ir_schedule_t));
+    conv_conf->crossfade    = -1.0;
+
+    memset(conv_conf->cache_dir, '\0', MAX_STR);
+    conv_conf->ir           = NULL;
+    conv_conf->spectra_h    = NULL;
+
+    conv_conf->raw_format   = 0;
+    conv_conf->raw_channels = 1;
+
+    conv_conf->out_subtype   = 0;
+    conv_conf->out_container = 0;
+    conv_conf->out_extension = NULL;
+
     conv_conf->info_flag    = 0;
     conv_conf->input_flag   = 0;
     conv_conf->quiet_flag   = 0;
     conv_conf->timer_flag   = 0;
     conv_conf->norm_flag    = 0;
+    conv_conf->norm_bound_flag = 0;
+    conv_conf->dither_flag  = 0;
+    conv_conf->complex_flag = 0;
+    conv_conf->matrix_flag  = 0;
+    conv_conf->stream_flag  = 0;
 
     conv_conf->outp    = NULL;
+    conv_conf->conv_fcn = NULL;
 }
 
 int get_options(int argc, char** restrict argv, conv_config_t* restrict conv_conf)
 {
     int dval = 0;
+    double fval = 0.0;
     int input_count = 0;
 
     if (argc == 1) {
@@ -43,21 +78,27 @@ int get_options(int argc, char** restrict argv, conv_config_t* restrict conv_con
     }
 
     for (int i = 1; i < argc; i++) {
-        if (argv[i][0] != '-' && argv[i - 1][0] != '-') {
-            CHECK_STR_LEN(argv[i]);
-            strcpy(conv_conf->input_info[input_count].ibuff, argv[i]);
-            CHECK_INPUT_COUNT_MAXMIN(input_count);
-            CHECK_RET(get_input_type(&conv_conf->input_info[input_count]));
-            input_count++;
+        if (!(strcmp(STDIN_NAME, argv[i])) || (argv[i][0] != '-' && (argv[i - 1][0] != '-' || !(strcmp(STDIN_NAME, argv[i - 1]))))) {
+            CHECK_RET(add_input(conv_conf, argv[i], &input_count));
             continue;
         }
 
         if (!(strcmp("-i", argv[i]))) {
+            CHECK_RET(add_input(conv_conf, argv[i + 1], &input_count));
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--h-list", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            CHECK_RET(read_input_list(conv_conf, argv[i + 1], H_INDEX));
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--x-list", argv[i]))) {
             CHECK_STR_LEN(argv[i + 1]);
-            strcpy(conv_conf->input_info[input_count].ibuff, argv[i + 1]);
-            CHECK_INPUT_COUNT_MAXMIN(input_count);
-            CHECK_RET(get_input_type(&conv_conf->input_info[input_count]));
-            input_count++;
+            CHECK_RET(read_input_list(conv_conf, argv[i + 1], X_INDEX));
             i++;
             continue;
         }
@@ -76,9 +117,91 @@ int get_options(int argc, char** restrict argv, conv_config_t* restrict conv_con
             continue;
         }
 
-        if (!(strcmp("-p", argv[i])) || !(strcmp("--precision", argv[i]))) {
+        if (!(strcmp("-e", argv[i])) || !(strcmp("--engine", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            CHECK_RET(select_engine(conv_conf, argv[i + 1]));
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--block-size", argv[i]))) {
+            CHECK_RES(sscanf(argv[i + 1], "%d", &dval));
+            CHECK_RES(dval > 0);
+            conv_conf->block_size = dval;
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--mem-limit", argv[i]))) {
+            CHECK_RES(sscanf(argv[i + 1], "%d", &dval));
+            CHECK_RES(dval > 0);
+            conv_conf->mem_limit = (size_t)dval << 20;
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--ir-schedule", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            CHECK_RET(read_schedule_file(conv_conf, argv[i + 1]));
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--crossfade", argv[i]))) {
+            CHECK_RES(sscanf(argv[i + 1], "%lf", &fval));
+            CHECK_RES(fval >= 0.0);
+            conv_conf->crossfade = fval / 1000.0;
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--cache-dir", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            strcpy(conv_conf->cache_dir, argv[i + 1]);
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--raw-dtype", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            CHECK_RET(select_raw_dtype(conv_conf, argv[i + 1]));
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--out-subtype", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            CHECK_RET(select_out_subtype(conv_conf, argv[i + 1]));
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--out-container", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            CHECK_RET(select_out_container(conv_conf, argv[i + 1]));
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("--raw-channels", argv[i]))) {
+            CHECK_RES(sscanf(argv[i + 1], "%d", &dval));
+            CHECK_RES(dval > 0 && dval <= UINT8_MAX);
+            conv_conf->raw_channels = dval;
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("-t", argv[i])) || !(strcmp("--threads", argv[i]))) {
             CHECK_RES(sscanf(argv[i + 1], "%d", &dval));
-            conv_conf->precision = dval;
+            CHECK_RES(dval > 0);
+            conv_conf->threads = dval;
+            i++;
+            continue;
+        }
+
+        if (!(strcmp("-p", argv[i])) || !(strcmp("--precision", argv[i]))) {
+            CHECK_STR_LEN(argv[i + 1]);
+            CHECK_RET(select_precision(conv_conf, argv[i + 1]));
             i++;
             continue;
         }
@@ -98,6 +221,26 @@ int get_options(int argc, char** restrict argv, conv_config_t* restrict conv_con
             continue;
         }
 
+        if (!(strcmp("--norm-bound", argv[i]))) {
+            conv_conf->norm_bound_flag = 1;
+            continue;
+        }
+
+        if (!(strcmp("--dither", argv[i]))) {
+            conv_conf->dither_flag = 1;
+            continue;
+        }
+
+        if (!(strcmp("--complex", argv[i]))) {
+            conv_conf->complex_flag = 1;
+            continue;
+        }
+
+        if (!(strcmp("--2d", argv[i]))) {
+            conv_conf->matrix_flag = 1;
+            continue;
+        }
+
         if (!(strcmp("-q", argv[i])) || !(strcmp("--quiet", argv[i]))) {
             conv_conf->quiet_flag = 1; 
             continue;
@@ -108,473 +251,4950 @@ int get_options(int argc, char** restrict argv, conv_config_t* restrict conv_con
         return 1;
     }
 
-    return 0;
-}
+    CHECK_RET(check_inputs(conv_conf));
 
-void check_timer_start(conv_config_t* restrict conv_conf)
-{
-    if (conv_conf->timer_flag && !conv_conf->quiet_flag) {
-        timespec_get(&conv_conf->start_time, TIME_UTC);
-        printf("Started timer.\n");
-    }
-}
+    if (conv_conf->mem_limit && (conv_conf->batch_count || conv_conf->stream_flag || conv_conf->conv_fcn || conv_conf->cache_dir[0] != '\0' ||
+                conv_conf->input_info[X_INDEX].input_type != AUDIO_TYPE_CHAR || conv_conf->input_info[H_INDEX].input_type != AUDIO_TYPE_CHAR ||
+                (conv_conf->outp && conv_conf->outp != &output_file_audio))) {
+        fprintf(stderr, "\nThe memory limit runs the out-of-core engine, which needs two audio file inputs and an audio output. It can not be used with an engine, a cache, a batch, or a stream.\n");
 
-int (*autoset_output_format(char type_x, char type_h)) (conv_config_t*, SF_INFO*, double*) {
-    if (type_x == 'a' || type_h == 'a') {
-        return &output_file_audio;
-    } else if (type_x == 'c' || type_h == 'c') {
-        return &output_file_csv;
-    } else {
-        return &output_stdout;
+        return 1;
     }
-}
-
-int get_input_type(input_info_t* restrict input_info)
-{
-    SNDFILE* file = NULL;   // Pointer to the input audio file
-    SF_INFO sf_info;        // Input audio file info
-
-    /* Initialise the struct */
-    memset(&sf_info, 0, sizeof(SF_INFO));
 
-    /* Check if input is valid and assign the type */
-    file = sf_open(input_info->ibuff, SFM_READ, &sf_info);
-    if (file) {
-        input_info->input_type = AUDIO_TYPE_CHAR;
-        input_info->inp = &read_audio_file_input;
-    } else if (!(check_csv_extension(get_extension(input_info->ibuff)))) {
-        input_info->input_type = CSV_TYPE_CHAR;
-        input_info->inp = &read_csv_string_file_input;
-    } else if (!(check_csv_string(input_info->ibuff))) {
-        input_info->input_type = STR_TYPE_CHAR;
-        input_info->inp = &read_csv_string_file_input;
-    } else {
-        fprintf(stderr, "Input '%s' is not an audio file or a CSV file/string.\n", input_info->ibuff);
+    if (conv_conf->cache_dir[0] != '\0' && conv_conf->conv_fcn && conv_conf->conv_fcn != &conv_block) {
+        fprintf(stderr, "\nThe spectrum cache is only used by the 'block' engine.\n");
 
         return 1;
     }
 
-    sf_close(file);
-
     return 0;
 }
 
-void conv(double* x, size_t size_x, double* h, size_t size_h, double* y, size_t size_y)
+int add_input(conv_config_t* restrict conv_conf, char* restrict ibuff, int* restrict input_count)
 {
-    for(size_t n = 0; n < size_y; n++) {
+    CHECK_STR_LEN(ibuff);
 
-        /* Limits */
-        size_t k_min = (0 > (int64_t)(n - (size_h - 1))) ? 0 : n - (size_h - 1);
-        size_t k_max = (n < size_x - 1) ? n : size_x - 1;
+    /* stdin can not be probed without consuming it */
+    if (!(strcmp(STDIN_NAME, ibuff))) {
+        if (*input_count != X_INDEX) {
+            fprintf(stderr, "\nOnly x[n] can be streamed from stdin.\n");
 
-        for(size_t k = k_min; k <= k_max; k++) {
-            y[n] += x[k] * h[n - k];
+            return 1;
         }
+
+        strcpy(conv_conf->input_info[X_INDEX].ibuff, ibuff);
+        conv_conf->input_info[X_INDEX].input_type = STDIN_TYPE_CHAR;
+        conv_conf->stream_flag = 1;
+    } else if (*input_count == X_INDEX) {
+        strcpy(conv_conf->input_info[X_INDEX].ibuff, ibuff);
+        CHECK_RET(get_input_type(&conv_conf->input_info[X_INDEX]));
+    } else {
+        CHECK_RET(add_batch_inputs(conv_conf, ibuff, H_INDEX));
     }
+
+    (*input_count)++;
+
+    return 0;
 }
 
-char* get_datetime_string()
+int add_batch_inputs(conv_config_t* restrict conv_conf, char* restrict ibuff, uint8_t index)
 {
-    time_t time_since_epoch = time(NULL);
-    struct tm* tm = localtime(&time_since_epoch);
-    static char s[13];
-    strftime(s, sizeof(s), "%d%m%y%H%M%S", tm);
+    CHECK_STR_LEN(ibuff);
 
-    return s;
+    if (strpbrk(ibuff, "*?[")) {
+        return expand_input_pattern(conv_conf, ibuff, index, 0);
+    }
+
+    return append_batch_input(conv_conf, ibuff, index);
 }
 
-char* get_extension(char* restrict ifile_name)
+int append_batch_input(conv_config_t* restrict conv_conf, char* restrict ibuff, uint8_t index)
 {
-    uint8_t extension_len = 0;
-    uint8_t dot_index = 0;
-    static char* extension = NULL;
+    if (conv_conf->batch_count && conv_conf->batch_index != index) {
+        fprintf(stderr, "\nOnly one of the inputs can be a batch.\n");
 
-    /* Remove the path specifier */
-    if (ifile_name[0] == '.' && ifile_name[1] == '\\') {
-        memmove(ifile_name, ifile_name + 2, MAX_STR - 2);
+        return 1;
     }
 
-    const uint16_t ifile_name_length = strlen(ifile_name);
+    input_info_t* batch_info = realloc(conv_conf->batch_info, (conv_conf->batch_count + 1) * sizeof(input_info_t));
+    if (!batch_info) {
+        fprintf(stderr, "\nUnable to allocate the batch inputs.\n");
 
-    for (uint16_t i = ifile_name_length; i > 0; i--) {
-        if (ifile_name[i] != '\0') {
-            extension_len++;
-            if (ifile_name[i] == '.') {
-                dot_index = i;
-                break;
-            }
-        }
+        return 1;
     }
 
-    extension = calloc(sizeof(char), extension_len);
-    for (uint16_t i = dot_index; i < ifile_name_length; i++) {
-        if (ifile_name[i] != '\0') {
-            extension[i - dot_index] = ifile_name[i];
+    conv_conf->batch_info = batch_info;
+    conv_conf->batch_index = index;
+
+    input_info_t* input_info = &conv_conf->batch_info[conv_conf->batch_count];
+    memset(input_info, 0, sizeof(input_info_t));
+    CHECK_STR_LEN(ibuff);
+    strcpy(input_info->ibuff, ibuff);
+    CHECK_RET(get_input_type(input_info));
+
+    /* Batches can hold more files than may be open at once, so only a batch of one keeps its probe */
+    if (conv_conf->batch_count) {
+        close_probe(input_info);
+        unmap_file(&input_info->map);
+        input_info->samples.data = NULL;
+        if (conv_conf->batch_count == 1) {
+            close_probe(&conv_conf->batch_info[0]);
+            unmap_file(&conv_conf->batch_info[0].map);
+            conv_conf->batch_info[0].samples.data = NULL;
         }
     }
 
-    if (strlen(extension) < 1) {
-        free(extension);
-
-        return "\0";
-    }
+    conv_conf->batch_count++;
 
-    return extension;
+    return 0;
 }
 
-void generate_file_name(char* restrict ofile, input_info_t* restrict input_info, uint8_t input_flag)
+int expand_input_pattern(conv_config_t* restrict conv_conf, char* restrict pattern, uint8_t index, uint8_t skip_flag)
 {
-    if (ofile[0] != '\0' ) {
+    size_t matches = 0;
 
-        return;
+#ifdef _WIN32
+    WIN32_FIND_DATAA find_data;
+    char path[MAX_STR];
+    size_t dir_len = 0;
+
+    /* FindFirstFile() returns bare file names, so keep the directory part of the pattern */
+    for (size_t i = 0; pattern[i] != '\0'; i++) {
+        if (pattern[i] == '\\' || pattern[i] == '/') {
+            dir_len = i + 1;
+        }
     }
 
-    char* ifile_no_extension_x = calloc(sizeof(char), MIN_STR);
-    char* ifile_no_extension_h = calloc(sizeof(char), MIN_STR);
-    char* extension_x = calloc(sizeof(char), MAX_EXT_STR);
-    char* extension_h = calloc(sizeof(char), MAX_EXT_STR);
+    HANDLE find = FindFirstFileA(pattern, &find_data);
+    if (find != INVALID_HANDLE_VALUE) {
+        do {
+            if (find_data.dwFileAttributes & FILE_ATTRIBUTE_DIRECTORY) {
+                continue;
+            }
+            if (dir_len + strlen(find_data.cFileName) >= MAX_STR) {
+                continue;
+            }
+            memcpy(path, pattern, dir_len);
+            strcpy(path + dir_len, find_data.cFileName);
+            if (append_batch_input(conv_conf, path, index)) {
+                if (skip_flag) {
+                    continue;
+                }
+                FindClose(find);
+
+                return 1;
+            }
+            matches++;
+        } while (FindNextFileA(find, &find_data));
 
+        FindClose(find);
+    }
+#else
+    glob_t glob_result;
 
-    switch (input_info[X_INDEX].input_type) {
-        case AUDIO_TYPE_CHAR:
-        case CSV_TYPE_CHAR:
-            extension_x = get_extension(input_info[X_INDEX].ibuff);
-            strncpy(ifile_no_extension_x, input_info[X_INDEX].ibuff, strlen(input_info[X_INDEX].ibuff) - strlen(extension_x));
-            break;
-        case STR_TYPE_CHAR:
-            strcpy(ifile_no_extension_x, "stringcsv");
-            break;
-        default:
-            fprintf(stderr, "Type char not supported.\n");
-            return;
+    if (!glob(pattern, GLOB_MARK, NULL, &glob_result)) {
+        for (size_t i = 0; i < glob_result.gl_pathc; i++) {
+            const char* path = glob_result.gl_pathv[i];
+
+            /* GLOB_MARK ends directories with a slash */
+            if (path[strlen(path) - 1] == '/') {
+                continue;
+            }
+            if (append_batch_input(conv_conf, glob_result.gl_pathv[i], index)) {
+                if (skip_flag) {
+                    continue;
+                }
+                globfree(&glob_result);
+
+                return 1;
+            }
+            matches++;
+        }
     }
 
-    switch (input_info[H_INDEX].input_type) {
-        case AUDIO_TYPE_CHAR:
-        case CSV_TYPE_CHAR:
-            extension_h = get_extension(input_info[H_INDEX].ibuff);
-            strncpy(ifile_no_extension_h, input_info[H_INDEX].ibuff, strlen(input_info[H_INDEX].ibuff) - strlen(extension_h));
-            break;
-        case STR_TYPE_CHAR:
-            strcpy(ifile_no_extension_h, "stringcsv");
-            break;
-        default:
-            fprintf(stderr, "Type char not supported.\n");
-            return;
+    globfree(&glob_result);
+#endif
+
+    if (!matches) {
+        fprintf(stderr, "No inputs match '%s'.\n", pattern);
+
+        return 1;
     }
 
-    /* Use the h[n] input to decide the output extension */
-    sprintf(ofile, "conv-%s-%s-%s%s", ifile_no_extension_x, ifile_no_extension_h, get_datetime_string(), extension_h);
+    return 0;
 }
 
-int select_output_format(conv_config_t* restrict conv_conf, char* restrict strval)
+int read_input_list(conv_config_t* restrict conv_conf, char* restrict list_file, uint8_t index)
 {
-    conv_conf->outp = NULL;
+    char line[MAX_STR + 2];
+    struct stat list_stat;
 
-    if(!(strcmp("audio", strval))) {
-        conv_conf->outp = &output_file_audio; 
-    }
-    if(!(strcmp("stdout", strval))) {
-        conv_conf->outp = &output_stdout; 
-    }
-    if(!(strcmp("stdout-csv", strval))) {
-        conv_conf->outp = &output_stdout_csv; 
-    }
-    if(!(strcmp("columns", strval))) {
-        conv_conf->outp = &output_file_columns; 
-    }
-    if(!(strcmp("csv", strval))) {
-        conv_conf->outp = &output_file_csv; 
+    if (strpbrk(list_file, "*?[")) {
+        return expand_input_pattern(conv_conf, list_file, index, 0);
     }
 
-    if (!conv_conf->outp){
-        fprintf(stderr, "\nOutput format '%s' not available.\n", strval);
+    /* A directory adds every input inside it */
+    if (!stat(list_file, &list_stat) && S_ISDIR(list_stat.st_mode)) {
+        char pattern[MAX_STR + 3];
+        sprintf(pattern, "%s/*", list_file);
 
-        return 1;
+        return expand_input_pattern(conv_conf, pattern, index, 1);
     }
 
-    return 0;
-}
+    FILE* file = fopen(list_file, "r");
+    if (!file) {
+        fprintf(stderr, "\nUnable to open input list '%s'.\n", list_file);
 
-int read_audio_file_input(input_info_t* restrict input_data, SF_INFO* restrict sf_info, double** restrict x)
-{
-    SNDFILE* file = NULL;          // Pointer to the input audio file
+        return 1;
+    }
 
-    /* Open the input file */
-    CHECK_ERR(open_audio_file(&file, sf_info, input_data->ibuff));
+    while (fgets(line, sizeof(line), file)) {
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') {
+            continue;
+        }
 
-    /* Read the input audio file */
-    CHECK_ERR(get_audio_file_data(file, sf_info, x));
+        if (add_batch_inputs(conv_conf, line, index)) {
+            fclose(file);
 
-    input_data->data_samples = sf_info->frames;
-    input_data->channels = sf_info->channels;
+            return 1;
+        }
+    }
 
-    sf_close(file);
+    fclose(file);
     return 0;
 }
 
-int open_audio_file(SNDFILE** restrict file, SF_INFO* restrict sf_info, char* restrict ibuff)
+int check_inputs(conv_config_t* restrict conv_conf)
 {
-    *file = sf_open(ibuff, SFM_READ, sf_info);
-    if(!(*file)) {
-        fprintf(stderr, "%s\n", sf_strerror(*file));
+    const uint8_t batch_x_flag = conv_conf->batch_count && conv_conf->batch_index == X_INDEX;
+    const uint8_t batch_h_flag = conv_conf->batch_count && conv_conf->batch_index == H_INDEX;
 
-        return 1;
+    /* With a batch of x[n] inputs the single input given is h[n] */
+    if (batch_x_flag && conv_conf->input_info[H_INDEX].ibuff[0] == '\0') {
+        conv_conf->input_info[H_INDEX] = conv_conf->input_info[X_INDEX];
+        memset(&conv_conf->input_info[X_INDEX], 0, sizeof(input_info_t));
     }
 
-    return 0;
+    const int input_count = (conv_conf->input_info[X_INDEX].ibuff[0] != '\0' || batch_x_flag) + (conv_conf->input_info[H_INDEX].ibuff[0] != '\0' || batch_h_flag);
+    CHECK_INPUT_COUNT_MIN(input_count);
+
+    /* The raw sample type may come after the inputs. Batch inputs are already spread over threads, so each one is parsed on one */
+    for (uint8_t i = 0; i < MAXMIN_INPUT_COUNT; i++) {
+        CHECK_RET(set_raw_input(conv_conf, &conv_conf->input_info[i]));
+        conv_conf->input_info[i].threads = conv_conf->threads;
+        conv_conf->input_info[i].complex_flag = conv_conf->complex_flag;
+        conv_conf->input_info[i].matrix_flag = conv_conf->matrix_flag;
+    }
+    for (size_t b = 0; b < conv_conf->batch_count; b++) {
+        CHECK_RET(set_raw_input(conv_conf, &conv_conf->batch_info[b]));
+        conv_conf->batch_info[b].threads = conv_conf->batch_count > 1 ? 1 : conv_conf->threads;
+        conv_conf->batch_info[b].complex_flag = conv_conf->complex_flag;
+        conv_conf->batch_info[b].matrix_flag = conv_conf->matrix_flag;
+    }
+    for (size_t s = 0; s < conv_conf->schedule.count; s++) {
+        CHECK_RET(set_raw_input(conv_conf, &conv_conf->schedule.inputs[s]));
+        conv_conf->schedule.inputs[s].threads = conv_conf->threads;
+    }
+
+    if (conv_conf->stream_flag) {
+        if (conv_conf->batch_count > 1 || conv_conf->ofile[0] != '\0' || conv_conf->norm_flag) {
+            fprintf(stderr, "\nStreaming from stdin writes to stdout, and can not be used with a batch, an output name, or normalisation.\n");
+
+            return 1;
+        }
+
+        if (conv_conf->conv_fcn && conv_conf->conv_fcn != &conv_block) {
+            fprintf(stderr, "\nStreaming from stdin uses the 'block' engine.\n");
+
+            return 1;
+        }
+
+        if (conv_conf->out_container || (conv_conf->out_subtype && !conv_conf->raw_format)) {
+            fprintf(stderr, "\nStreams to stdout keep the layout of x[n], only the subtype of a raw stream can be changed.\n");
+
+            return 1;
+        }
+
+        /* stdout carries the data */
+        conv_conf->quiet_flag = 1;
+    }
+
+    if ((conv_conf->out_subtype || conv_conf->out_container) && conv_conf->outp && conv_conf->outp != &output_file_audio) {
+        fprintf(stderr, "\nThe output subtype and container only apply to audio outputs.\n");
+
+        return 1;
+    }
+
+    /* Both given together can be checked before the inputs are read */
+    if (conv_conf->out_subtype && conv_conf->out_container) {
+        SF_INFO sf_info_y = {0};
+
+        sf_info_y.channels = 1;
+        sf_info_y.samplerate = RAW_SAMPLERATE;
+        CHECK_RET(set_output_format(conv_conf, &sf_info_y));
+    }
+
+    /* A container alone keeps the subtype of the input y[n] takes its format from, which is known once the inputs are probed */
+    if (conv_conf->out_container && !conv_conf->out_subtype) {
+        if (!conv_conf->batch_count) {
+            CHECK_RET(check_out_container(conv_conf, &conv_conf->input_info[X_INDEX], &conv_conf->input_info[H_INDEX]));
+        }
+        for (size_t b = 0; b < conv_conf->batch_count; b++) {
+            CHECK_RET(check_out_container(conv_conf, batch_x_flag ? &conv_conf->batch_info[b] : &conv_conf->input_info[X_INDEX], batch_h_flag ? &conv_conf->batch_info[b] : &conv_conf->input_info[H_INDEX]));
+        }
+    }
+
+    if (conv_conf->complex_flag && (conv_conf->stream_flag || conv_conf->mem_limit || conv_conf->batch_count > 1 || conv_conf->norm_bound_flag || conv_conf->cache_dir[0] != '\0' ||
+                (conv_conf->conv_fcn && conv_conf->conv_fcn != &conv_direct && conv_conf->conv_fcn != &conv_fft))) {
+        fprintf(stderr, "\nComplex inputs are convolved in memory by the 'direct' and 'fft' engines, and can not be used with a batch, a stream, '--mem-limit', '--cache-dir', or '--norm-bound'.\n");
+
+        return 1;
+    }
+
+    if (conv_conf->matrix_flag) {
+        uint8_t text_flag = 1;
+        for (uint8_t i = 0; i < MAXMIN_INPUT_COUNT; i++) {
+            text_flag &= conv_conf->input_info[i].ibuff[0] == '\0' || check_text_input(conv_conf->input_info[i].input_type);
+        }
+        for (size_t b = 0; b < conv_conf->batch_count; b++) {
+            text_flag &= check_text_input(conv_conf->batch_info[b].input_type);
+        }
+
+        if (!text_flag || conv_conf->stream_flag || conv_conf->mem_limit || conv_conf->batch_count > 1 || conv_conf->complex_flag || conv_conf->norm_bound_flag || conv_conf->cache_dir[0] != '\0' ||
+                conv_conf->out_subtype || conv_conf->out_container || conv_conf->outp == &output_file_audio ||
+                (conv_conf->conv_fcn && conv_conf->conv_fcn != &conv_direct && conv_conf->conv_fcn != &conv_fft && conv_conf->conv_fcn != &conv_separable_2d)) {
+            fprintf(stderr, "\nMatrices are read from CSV files or strings and convolved in memory by the 'direct', 'fft', and 'separable' engines. They can not be used with a batch, a stream, complex inputs, an audio output, '--mem-limit', '--cache-dir', or '--norm-bound'.\n");
+
+            return 1;
+        }
+    } else if (conv_conf->conv_fcn == &conv_separable_2d) {
+        fprintf(stderr, "\nThe 'separable' engine convolves matrices, use it with '--2d'.\n");
+
+        return 1;
+    }
+
+    if (conv_conf->crossfade >= 0.0 && !conv_conf->schedule.count) {
+        fprintf(stderr, "\nThe crossfade only applies to the switches of an '--ir-schedule'.\n");
+
+        return 1;
+    }
+
+    if (conv_conf->schedule.count) {
+        if (conv_conf->stream_flag || conv_conf->mem_limit || conv_conf->batch_count > 1 || conv_conf->complex_flag || conv_conf->matrix_flag || conv_conf->norm_bound_flag ||
+                (conv_conf->conv_fcn && conv_conf->conv_fcn != &conv_block)) {
+            fprintf(stderr, "\nThe h[n] schedule runs on the 'block' engine, and can not be used with a batch, a stream, complex inputs, matrices, '--mem-limit', or '--norm-bound'.\n");
+
+            return 1;
+        }
+
+        conv_conf->conv_fcn = &conv_block;
+    }
+
+    if (conv_conf->norm_bound_flag && (conv_conf->norm_flag || conv_conf->batch_count > 1)) {
+        fprintf(stderr, "\nThe peak bound can not be used with '--norm' or a batch.\n");
+
+        return 1;
+    }
+
+    /* A batch of one is a normal input */
+    if (conv_conf->batch_count == 1) {
+        conv_conf->input_info[conv_conf->batch_index] = conv_conf->batch_info[0];
+        free(conv_conf->batch_info);
+        conv_conf->batch_info = NULL;
+        conv_conf->batch_count = 0;
+
+        return 0;
+    }
+
+    if (conv_conf->batch_count && conv_conf->ofile[0] != '\0') {
+        fprintf(stderr, "\nAn output name can not be used with a batch, the names are generated for every output.\n");
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int read_inputs(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_x, SF_INFO* restrict sf_info_h, double** restrict x, double** restrict h)
+{
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    input_reader_t reader = {info_x, sf_info_x, x, 0.0, 0};
+    struct timespec start;
+    pthread_t thread;
+    uint8_t thread_flag = 0;
+
+    /* The x[n] thread owns its input info until it is joined */
+    const size_t size_x = info_x->data_samples;
+    const uint8_t channels_x = info_x->channels;
+
+    timespec_get(&start, TIME_UTC);
+
+    thread_flag = !pthread_create(&thread, NULL, input_reader_worker, &reader);
+    if (!thread_flag) {
+        input_reader_worker(&reader);
+    }
+
+    int ret = read_ir_input(conv_conf, sf_info_h, h);
+    if (!ret) {
+        prepare_h(conv_conf, *h, size_x, channels_x);
+    }
+    const double h_seconds = get_seconds_since(&start);
+
+    if (thread_flag) {
+        pthread_join(thread, NULL);
+    }
+
+    if (ret || reader.ret) {
+        return 1;
+    }
+
+    /* Drop the h[n] spectra if the probe got the size of x[n] wrong */
+    if (conv_conf->spectra_h && (info_x->data_samples != size_x || info_x->channels != channels_x)) {
+        free_spectra(conv_conf->spectra_h);
+        free(conv_conf->spectra_h);
+        conv_conf->spectra_h = NULL;
+    }
+
+    if (conv_conf->timer_flag && !conv_conf->quiet_flag) {
+        printf("Read x[n] in %.9lf seconds and h[n] in %.9lf seconds, inputs ready after %.9lf seconds.\n", reader.seconds, h_seconds, get_seconds_since(&start));
+        for (uint8_t i = 0; i < MAXMIN_INPUT_COUNT; i++) {
+            input_info_t* info = &conv_conf->input_info[i];
+            if (check_text_input(info->input_type) && info->text_seconds > 0.0) {
+                printf("Parsed %s at %.1lf MB/s, %zu bytes in %.9lf seconds.\n", i == X_INDEX ? "x[n]" : "h[n]", info->text_bytes / info->text_seconds / 1e6, info->text_bytes, info->text_seconds);
+            }
+        }
+    }
+
+    return 0;
+}
+
+void* input_reader_worker(void* arg)
+{
+    input_reader_t* reader = arg;
+    struct timespec start;
+
+    timespec_get(&start, TIME_UTC);
+    reader->ret = reader->input_info->inp(reader->input_info, reader->sf_info, reader->x);
+    reader->seconds = get_seconds_since(&start);
+
+    return NULL;
+}
+
+void prepare_h(conv_config_t* restrict conv_conf, double* restrict h, size_t size_x, uint8_t channels_x)
+{
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const uint8_t channels = channels_x > info_h->channels ? channels_x : info_h->channels;
+    const samples_t h_samples = get_input_samples(info_h, h);
+
+    /* CSV sizes are only known once they are read, cached h[n] spectra are ready already, and complex inputs are transformed whole */
+    if (check_text_input(conv_conf->input_info[X_INDEX].input_type) || conv_conf->ir || conv_conf->complex_flag) {
+        return;
+    }
+
+    /* x[n] may still be being read, so the engine is only guessed here and picked once both inputs are in, when 16-bit x[n] samples are known */
+    int (*conv_fcn)(conv_config_t*, double*, double*, double*) = conv_conf->conv_fcn ? conv_conf->conv_fcn : autoset_engine(conv_conf, size_x, info_h->data_samples);
+
+    /* The engines transform h[n] themselves if anything here fails */
+    if (conv_fcn == &conv_block) {
+        fft_plan_t* plan = create_fft_plan(2 * get_block_size(conv_conf->block_size, info_h->data_samples));
+        if (plan) {
+            conv_conf->ir = partition_ir(plan, h_samples, info_h->data_samples, info_h->channels);
+        }
+        destroy_fft_plan(plan);
+    } else if (conv_fcn == &conv_fft && channels > 1) {
+        fft_plan_t* plan = create_fft_plan(nextpow2(size_x + info_h->data_samples - 1));
+        conv_conf->spectra_h = calloc(1, sizeof(spectra_t));
+        if (!plan || !conv_conf->spectra_h || transform_channels(plan, h_samples, info_h->data_samples, info_h->channels, channels, conv_conf->spectra_h)) {
+            if (conv_conf->spectra_h) {
+                free_spectra(conv_conf->spectra_h);
+            }
+            free(conv_conf->spectra_h);
+            conv_conf->spectra_h = NULL;
+        }
+        destroy_fft_plan(plan);
+    }
+}
+
+double get_seconds_since(struct timespec* restrict start)
+{
+    struct timespec end;
+
+    timespec_get(&end, TIME_UTC);
+    return (end.tv_sec - start->tv_sec) + ((end.tv_nsec - start->tv_nsec) / 1e9);
+}
+
+void check_timer_start(conv_config_t* restrict conv_conf)
+{
+    if (conv_conf->timer_flag && !conv_conf->quiet_flag) {
+        timespec_get(&conv_conf->start_time, TIME_UTC);
+        printf("Started timer.\n");
+    }
+}
+
+int (*autoset_output_format(char type_x, char type_h)) (conv_config_t*, SF_INFO*, double*) {
+    if (type_x == 'a' || type_h == 'a') {
+        return &output_file_audio;
+    } else if (type_x == 'c' || type_h == 'c') {
+        return &output_file_csv;
+    } else if (type_x == NPY_TYPE_CHAR || type_h == NPY_TYPE_CHAR) {
+        return &output_file_npy;
+    } else if (type_x == RAW_TYPE_CHAR || type_h == RAW_TYPE_CHAR) {
+        return &output_file_raw_f64;
+    } else {
+        return &output_stdout;
+    }
+}
+
+int get_input_type(input_info_t* restrict input_info)
+{
+    SNDFILE* file = NULL;   // Pointer to the input audio file
+    SF_INFO sf_info;        // Input audio file info
+
+    /* Initialise the struct */
+    memset(&sf_info, 0, sizeof(SF_INFO));
+
+    /* Check if input is valid and assign the type */
+    file = sf_open(input_info->ibuff, SFM_READ, &sf_info);
+    if (file) {
+        input_info->input_type = AUDIO_TYPE_CHAR;
+        input_info->inp = &read_audio_file_input;
+        input_info->data_samples = sf_info.frames;
+        input_info->channels = sf_info.channels;
+
+        /* The reader decodes from the probe handle instead of opening the file again */
+        input_info->probe_file = file;
+        input_info->probe_info = sf_info;
+    } else if (!(strcmp(NPY_EXT, get_extension(input_info->ibuff)))) {
+        input_info->input_type = NPY_TYPE_CHAR;
+        input_info->inp = &read_npy_input;
+
+        /* The shape is known from the header, so the engines can be prepared before reading. The mapping is kept for the reader */
+        CHECK_RET(read_npy_input(input_info, &sf_info, NULL));
+    } else if (!(check_raw_extension(get_extension(input_info->ibuff)))) {
+        input_info->input_type = RAW_TYPE_CHAR;
+        input_info->inp = &read_raw_input;
+    } else if (!(check_csv_extension(get_extension(input_info->ibuff)))) {
+        input_info->input_type = CSV_TYPE_CHAR;
+        input_info->inp = &read_csv_string_file_input;
+    } else if (!(probe_csv_string(input_info))) {
+        input_info->input_type = STR_TYPE_CHAR;
+        input_info->inp = &read_csv_string_file_input;
+    } else {
+        fprintf(stderr, "Input '%s' is not an audio file, a raw or .npy file, or a CSV file/string.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+void conv(double* x, size_t size_x, double* h, size_t size_h, double* y, size_t size_y, output_stats_t* restrict stats)
+{
+    for(size_t n = 0; n < size_y; n++) {
+
+        /* Limits */
+        size_t k_min = (0 > (int64_t)(n - (size_h - 1))) ? 0 : n - (size_h - 1);
+        size_t k_max = (n < size_x - 1) ? n : size_x - 1;
+
+        for(size_t k = k_min; k <= k_max; k++) {
+            y[n] += x[k] * h[n - k];
+        }
+        track_sample(stats, y[n]);
+    }
+}
+
+void conv_s16(const int16_t* restrict x, size_t size_x, const int16_t* restrict h_rev, size_t size_h, double* restrict y, uint8_t stride, size_t size_y, output_stats_t* restrict stats)
+{
+    for (size_t n = 0; n < size_y; n++) {
+        const size_t k_min = n < size_h - 1 ? 0 : n - (size_h - 1);
+        const size_t k_max = n < size_x - 1 ? n : size_x - 1;
+        const int16_t* restrict x_k = x + k_min;
+        const int16_t* restrict h_k = h_rev + (size_h - 1 - n + k_min);
+        int64_t acc = 0;
+
+        /* With h[n] reversed both sides run forward, so the sum is a widening dot product */
+        for (size_t i = 0; i <= k_max - k_min; i++) {
+            acc += (int32_t)x_k[i] * h_k[i];
+        }
+
+        y[n * stride] = acc * PCM16_PRODUCT_SCALE;
+        track_sample(stats, y[n * stride]);
+    }
+}
+
+void get_channel_s16(const void* restrict x, size_t frames, uint8_t channels, uint8_t channel, uint8_t reverse_flag, int16_t* restrict x_ch)
+{
+    const char* src = (const char*)x + channel * sizeof(int16_t);
+
+    for (size_t n = 0; n < frames; n++) {
+        memcpy(&x_ch[reverse_flag ? frames - 1 - n : n], src + n * channels * sizeof(int16_t), sizeof(int16_t));
+    }
+}
+
+int select_engine(conv_config_t* restrict conv_conf, char* restrict strval)
+{
+    conv_conf->conv_fcn = NULL;
+
+    if(!(strcmp("direct", strval))) {
+        conv_conf->conv_fcn = &conv_direct;
+    }
+    if(!(strcmp("direct-s16", strval))) {
+        conv_conf->conv_fcn = &conv_direct_s16;
+    }
+    if(!(strcmp("fft", strval))) {
+        conv_conf->conv_fcn = &conv_fft;
+    }
+    if(!(strcmp("block", strval))) {
+        conv_conf->conv_fcn = &conv_block;
+    }
+    if(!(strcmp("separable", strval))) {
+        conv_conf->conv_fcn = &conv_separable_2d;
+    }
+
+    if (!conv_conf->conv_fcn){
+        fprintf(stderr, "\nEngine '%s' not available.\n", strval);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int (*autoset_engine(conv_config_t* restrict conv_conf, size_t size_x, size_t size_h)) (conv_config_t*, double*, double*, double*) {
+    if (conv_conf->cache_dir[0] != '\0') {
+        return &conv_block;
+    } else if (size_x <= DIRECT_MAX_SAMPLES || size_h <= DIRECT_MAX_SAMPLES) {
+        return check_s16_input(&conv_conf->input_info[X_INDEX]) && check_s16_input(&conv_conf->input_info[H_INDEX]) ? &conv_direct_s16 : &conv_direct;
+    } else {
+        return &conv_fft;
+    }
+}
+
+void get_channel(samples_t x, size_t frames, uint8_t channels, uint8_t channel, double* restrict x_ch)
+{
+    for (size_t n = 0; n < frames; n++) {
+        x_ch[n] = get_sample(x, n * channels + channel);
+    }
+}
+
+void set_channel(double* restrict y, size_t frames, uint8_t channels, uint8_t channel, double* restrict y_ch)
+{
+    for (size_t n = 0; n < frames; n++) {
+        y[n * channels + channel] = y_ch[n];
+    }
+}
+
+uint8_t check_s16_input(input_info_t* restrict input_info)
+{
+    return input_info->samples.data && input_info->samples.format == SF_FORMAT_PCM_16;
+}
+
+samples_t double_samples(double* x)
+{
+    samples_t samples = {x, SF_FORMAT_DOUBLE};
+
+    return samples;
+}
+
+samples_t get_input_samples(input_info_t* restrict input_info, double* restrict x)
+{
+    if (input_info->samples.data) {
+        return input_info->samples;
+    }
+
+    return double_samples(x);
+}
+
+samples_t offset_samples(samples_t x, size_t count)
+{
+    x.data = (const char*)x.data + count * get_sample_bytes(x.format);
+
+    return x;
+}
+
+size_t get_sample_bytes(int format)
+{
+    switch (format) {
+        case SF_FORMAT_PCM_16:
+            return sizeof(int16_t);
+        case SF_FORMAT_PCM_24:
+            return 3;
+        case SF_FORMAT_PCM_32:
+            return sizeof(int32_t);
+        case SF_FORMAT_FLOAT:
+            return sizeof(float);
+        case SF_FORMAT_DOUBLE:
+            return sizeof(double);
+        default:
+            return 0;
+    }
+}
+
+int conv_direct(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    const size_t size_x = conv_conf->input_info[X_INDEX].data_samples;
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+    const uint8_t channels_x = conv_conf->input_info[X_INDEX].channels;
+    const uint8_t channels_h = conv_conf->input_info[H_INDEX].channels;
+    const size_t size_y = conv_conf->total_samples;
+    const samples_t x_samples = get_input_samples(&conv_conf->input_info[X_INDEX], x);
+    const samples_t h_samples = get_input_samples(&conv_conf->input_info[H_INDEX], h);
+
+    /* I/Q inputs are convolved as one complex channel */
+    if (conv_conf->complex_flag) {
+        return conv_direct_complex(conv_conf, x, h, y);
+    }
+
+    if (conv_conf->matrix_flag) {
+        return conv_direct_2d(conv_conf, x, h, y);
+    }
+
+    /* Decoded mono inputs are already contiguous */
+    if (conv_conf->channels == 1 && x && h) {
+        conv(x, size_x, h, size_h, y, size_y, &conv_conf->stats);
+
+        return 0;
+    }
+
+    double* x_ch = malloc(size_x * sizeof(double));
+    double* h_ch = malloc(size_h * sizeof(double));
+    double* y_ch = malloc(size_y * sizeof(double));
+    if (!x_ch || !h_ch || !y_ch) {
+        fprintf(stderr, "\nUnable to allocate the channel buffers.\n");
+        free(x_ch);
+        free(h_ch);
+        free(y_ch);
+
+        return 1;
+    }
+
+    for (uint8_t c = 0; c < conv_conf->channels; c++) {
+        get_channel(x_samples, size_x, channels_x, c % channels_x, x_ch);
+        get_channel(h_samples, size_h, channels_h, c % channels_h, h_ch);
+        memset(y_ch, 0, size_y * sizeof(double));
+        conv(x_ch, size_x, h_ch, size_h, y_ch, size_y, &conv_conf->stats);
+        set_channel(y, size_y, conv_conf->channels, c, y_ch);
+    }
+
+    free(x_ch);
+    free(h_ch);
+    free(y_ch);
+    return 0;
+}
+
+int conv_direct_s16(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    const size_t size_x = conv_conf->input_info[X_INDEX].data_samples;
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+    const uint8_t channels_x = conv_conf->input_info[X_INDEX].channels;
+    const uint8_t channels_h = conv_conf->input_info[H_INDEX].channels;
+    const size_t size_y = conv_conf->total_samples;
+
+    /* Anything but real 16-bit PCM on both sides goes through the double sum */
+    if (conv_conf->complex_flag || !check_s16_input(&conv_conf->input_info[X_INDEX]) || !check_s16_input(&conv_conf->input_info[H_INDEX])) {
+        return conv_direct(conv_conf, x, h, y);
+    }
+
+    int16_t* x_ch = malloc(size_x * sizeof(int16_t));
+    int16_t* h_ch = malloc(size_h * sizeof(int16_t));
+    if (!x_ch || !h_ch) {
+        fprintf(stderr, "\nUnable to allocate the channel buffers.\n");
+        free(x_ch);
+        free(h_ch);
+
+        return 1;
+    }
+
+    for (uint8_t c = 0; c < conv_conf->channels; c++) {
+        get_channel_s16(conv_conf->input_info[X_INDEX].samples.data, size_x, channels_x, c % channels_x, 0, x_ch);
+        get_channel_s16(conv_conf->input_info[H_INDEX].samples.data, size_h, channels_h, c % channels_h, 1, h_ch);
+        conv_s16(x_ch, size_x, h_ch, size_h, y + c, conv_conf->channels, size_y, &conv_conf->stats);
+    }
+
+    free(x_ch);
+    free(h_ch);
+    return 0;
+}
+
+int conv_fft(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    const size_t size_x = conv_conf->input_info[X_INDEX].data_samples;
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+    const uint8_t channels_x = conv_conf->input_info[X_INDEX].channels;
+    const size_t size_y = conv_conf->total_samples;
+    const size_t N = nextpow2(size_y);
+    const samples_t x_samples = get_input_samples(&conv_conf->input_info[X_INDEX], x);
+
+    if (conv_conf->complex_flag) {
+        return conv_fft_complex(conv_conf, x, h, y);
+    }
+
+    if (conv_conf->matrix_flag) {
+        return conv_fft_2d(conv_conf, x, h, y);
+    }
+
+    fft_plan_t* plan = create_fft_plan(N);
+    if (!plan) {
+        fprintf(stderr, "\nUnable to allocate a %zu point FFT.\n", N);
+
+        return 1;
+    }
+
+    /* Both mono, x[n] goes in the real part and h[n] in the imaginary part of one transform */
+    if (conv_conf->channels == 1) {
+        double complex* Z = malloc(N * sizeof(double complex));
+        if (!Z) {
+            fprintf(stderr, "\nUnable to allocate a %zu point FFT.\n", N);
+            destroy_fft_plan(plan);
+
+            return 1;
+        }
+
+        const samples_t h_samples = get_input_samples(&conv_conf->input_info[H_INDEX], h);
+
+        pack_channel_pair(Z, N, x_samples, size_x, 1, 0, NO_CHANNEL);
+        for (size_t n = 0; n < size_h; n++) {
+            Z[n] = CMPLX(creal(Z[n]), get_sample(h_samples, n));
+        }
+        fft(plan, Z, 0);
+        multiply_packed_inputs(Z, N);
+        fft(plan, Z, 1);
+        unpack_channel_pair(Z, N, y, size_y, 1, 0, NO_CHANNEL, &conv_conf->stats);
+
+        destroy_fft_plan(plan);
+        free(Z);
+        return 0;
+    }
+
+    /* Otherwise every pair of output channels shares one transform per input */
+    spectra_t X = {0};
+    int ret = transform_channels(plan, x_samples, size_x, channels_x, conv_conf->channels, &X);
+    if (!ret) {
+        ret = conv_fft_transformed(conv_conf, plan, &X, h, y);
+    }
+
+    free_spectra(&X);
+    destroy_fft_plan(plan);
+    return ret;
+}
+
+int conv_direct_complex(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    double complex* x_buf = NULL;
+    double complex* h_buf = NULL;
+    const double complex* x_c = get_complex_input(&conv_conf->input_info[X_INDEX], x, &x_buf);
+    const double complex* h_c = get_complex_input(&conv_conf->input_info[H_INDEX], h, &h_buf);
+
+    if (!x_c || !h_c) {
+        fprintf(stderr, "\nUnable to allocate the complex inputs.\n");
+        free(x_buf);
+        free(h_buf);
+
+        return 1;
+    }
+
+    /* The I/Q output channels are the parts of one complex output */
+    conv_complex(x_c, conv_conf->input_info[X_INDEX].data_samples, h_c, conv_conf->input_info[H_INDEX].data_samples, (double complex*)y, conv_conf->total_samples, &conv_conf->stats);
+
+    free(x_buf);
+    free(h_buf);
+    return 0;
+}
+
+int conv_fft_complex(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const size_t N = nextpow2(conv_conf->total_samples);
+
+    fft_plan_t* plan = create_fft_plan(N);
+    double complex* X = malloc(N * sizeof(double complex));
+    double complex* H = malloc(N * sizeof(double complex));
+    if (!plan || !X || !H) {
+        fprintf(stderr, "\nUnable to allocate a %zu point FFT.\n", N);
+        destroy_fft_plan(plan);
+        free(X);
+        free(H);
+
+        return 1;
+    }
+
+    /* I goes in the real part and Q in the imaginary part, so each input is a single transform */
+    pack_channel_pair(X, N, get_input_samples(info_x, x), info_x->data_samples, info_x->channels, 0, info_x->channels > 1 ? 1 : NO_CHANNEL);
+    pack_channel_pair(H, N, get_input_samples(info_h, h), info_h->data_samples, info_h->channels, 0, info_h->channels > 1 ? 1 : NO_CHANNEL);
+    fft(plan, X, 0);
+    fft(plan, H, 0);
+    for (size_t k = 0; k < N; k++) {
+        X[k] = complex_mul(X[k], H[k]);
+    }
+    fft(plan, X, 1);
+    unpack_channel_pair(X, N, y, conv_conf->total_samples, 2, 0, 1, &conv_conf->stats);
+
+    destroy_fft_plan(plan);
+    free(X);
+    free(H);
+    return 0;
+}
+
+void conv_complex(const double complex* restrict x, size_t size_x, const double complex* restrict h, size_t size_h, double complex* restrict y, size_t size_y, output_stats_t* restrict stats)
+{
+    for (size_t n = 0; n < size_y; n++) {
+        const size_t k_min = n < size_h - 1 ? 0 : n - (size_h - 1);
+        const size_t k_max = n < size_x - 1 ? n : size_x - 1;
+        double complex acc = 0.0;
+
+        for (size_t k = k_min; k <= k_max; k++) {
+            acc += complex_mul(x[k], h[n - k]);
+        }
+
+        y[n] = acc;
+        track_sample(stats, creal(acc));
+        track_sample(stats, cimag(acc));
+    }
+}
+
+const double complex* get_complex_input(input_info_t* restrict input_info, double* restrict x, double complex** restrict buf)
+{
+    const size_t frames = input_info->data_samples;
+
+    /* Decoded I/Q doubles already have the layout of complex doubles */
+    if (x && !input_info->samples.data && input_info->channels == 2) {
+        return (const double complex*)x;
+    }
+
+    *buf = malloc(frames * sizeof(double complex));
+    if (!*buf) {
+        return NULL;
+    }
+    pack_channel_pair(*buf, frames, get_input_samples(input_info, x), frames, input_info->channels, 0, input_info->channels > 1 ? 1 : NO_CHANNEL);
+
+    return *buf;
+}
+
+int check_complex_channels(conv_config_t* restrict conv_conf)
+{
+    for (uint8_t i = 0; i < MAXMIN_INPUT_COUNT; i++) {
+        input_info_t* info = &conv_conf->input_info[i];
+
+        if (info->channels > 2) {
+            fprintf(stderr, "\nComplex input '%s' has %d channels, I/Q inputs have 2 and real inputs have 1.\n", info->ibuff, info->channels);
+
+            return 1;
+        }
+    }
+
+    conv_conf->channels = 2;
+
+    return 0;
+}
+
+int conv_direct_2d(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    const size_t rows_x = conv_conf->input_info[X_INDEX].rows;
+    const size_t rows_h = conv_conf->input_info[H_INDEX].rows;
+    const size_t columns_x = get_matrix_columns(&conv_conf->input_info[X_INDEX]);
+    const size_t columns_h = get_matrix_columns(&conv_conf->input_info[H_INDEX]);
+    const size_t columns_y = conv_conf->columns;
+
+    /* The inner loop adds a row of h[n] along a row of y[n], so it runs over contiguous memory */
+    for (size_t m = 0; m < rows_x; m++) {
+        for (size_t r = 0; r < rows_h; r++) {
+            double* restrict y_row = y + (m + r) * columns_y;
+            const double* restrict h_row = h + r * columns_h;
+
+            for (size_t n = 0; n < columns_x; n++) {
+                const double x_mn = x[m * columns_x + n];
+                for (size_t k = 0; k < columns_h; k++) {
+                    y_row[n + k] += x_mn * h_row[k];
+                }
+            }
+        }
+    }
+
+    track_samples(&conv_conf->stats, y, conv_conf->total_samples);
+    return 0;
+}
+
+int conv_fft_2d(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    const size_t rows_x = conv_conf->input_info[X_INDEX].rows;
+    const size_t rows_h = conv_conf->input_info[H_INDEX].rows;
+    const size_t columns_x = get_matrix_columns(&conv_conf->input_info[X_INDEX]);
+    const size_t columns_h = get_matrix_columns(&conv_conf->input_info[H_INDEX]);
+    const size_t columns_y = conv_conf->columns;
+    const size_t rows_y = conv_conf->total_samples / columns_y;
+    const size_t R = nextpow2(rows_y);
+    const size_t C = nextpow2(columns_y);
+    const double scale = 1.0 / (R * C);
+
+    fft_plan_t* row_plan = create_fft_plan(C);
+    fft_plan_t* column_plan = create_fft_plan(R);
+    double complex* Z = calloc(R * C, sizeof(double complex));
+    double complex* column = malloc(R * sizeof(double complex));
+    if (!row_plan || !column_plan || !Z || !column) {
+        fprintf(stderr, "\nUnable to allocate a %zu by %zu point FFT.\n", R, C);
+        destroy_fft_plan(row_plan);
+        destroy_fft_plan(column_plan);
+        free(Z);
+        free(column);
+
+        return 1;
+    }
+
+    /* x[n] goes in the real part and h[n] in the imaginary part of one transform */
+    for (size_t m = 0; m < rows_x; m++) {
+        for (size_t n = 0; n < columns_x; n++) {
+            Z[m * C + n] = x[m * columns_x + n];
+        }
+    }
+    for (size_t m = 0; m < rows_h; m++) {
+        for (size_t n = 0; n < columns_h; n++) {
+            Z[m * C + n] = CMPLX(creal(Z[m * C + n]), h[m * columns_h + n]);
+        }
+    }
+
+    fft_2d(row_plan, column_plan, Z, rows_x > rows_h ? rows_x : rows_h, column, 0);
+    multiply_packed_inputs_2d(Z, R, C);
+    fft_2d(row_plan, column_plan, Z, rows_y, column, 1);
+
+    for (size_t m = 0; m < rows_y; m++) {
+        for (size_t n = 0; n < columns_y; n++) {
+            y[m * columns_y + n] = creal(Z[m * C + n]) * scale;
+            track_sample(&conv_conf->stats, y[m * columns_y + n]);
+        }
+    }
+
+    destroy_fft_plan(row_plan);
+    destroy_fft_plan(column_plan);
+    free(Z);
+    free(column);
+    return 0;
+}
+
+int conv_separable_2d(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    const size_t rows_x = conv_conf->input_info[X_INDEX].rows;
+    const size_t rows_h = conv_conf->input_info[H_INDEX].rows;
+    const size_t columns_x = get_matrix_columns(&conv_conf->input_info[X_INDEX]);
+    const size_t columns_h = get_matrix_columns(&conv_conf->input_info[H_INDEX]);
+    const size_t columns_y = conv_conf->columns;
+    output_stats_t row_stats = {0};
+
+    double* u = malloc(rows_h * sizeof(double));
+    double* v = malloc(columns_h * sizeof(double));
+    double* rows = calloc(rows_x * columns_y, sizeof(double));
+    if (!u || !v || !rows) {
+        fprintf(stderr, "\nUnable to allocate the separable passes.\n");
+        free(u);
+        free(v);
+        free(rows);
+
+        return 1;
+    }
+
+    /* Asked for by name, a kernel that is rank-1 up to the rounding of its text is split too, with that rounding in y[n] */
+    if (!factor_separable(h, rows_h, columns_h, u, v, 0)) {
+        if (!factor_separable(h, rows_h, columns_h, u, v, 1)) {
+            fprintf(stderr, "\nh[n] is not a rank-1 matrix, so it can not be split into a row and a column for the 'separable' engine.\n");
+            free(u);
+            free(v);
+            free(rows);
+
+            return 1;
+        }
+
+        fprintf(stderr, "h[n] is rank-1 only to within the rounding of its last decimal, the 'separable' output differs from the other engines by about as much.\n");
+    }
+
+    /* Every row of x[n] with the row factor */
+    for (size_t m = 0; m < rows_x; m++) {
+        conv(x + m * columns_x, columns_x, v, columns_h, rows + m * columns_y, columns_y, &row_stats);
+    }
+
+    /* Then every column of that with the column factor, adding whole rows so the loop stays contiguous */
+    for (size_t m = 0; m < rows_x; m++) {
+        const double* restrict row = rows + m * columns_y;
+
+        for (size_t r = 0; r < rows_h; r++) {
+            double* restrict y_row = y + (m + r) * columns_y;
+            const double u_r = u[r];
+
+            for (size_t n = 0; n < columns_y; n++) {
+                y_row[n] += u_r * row[n];
+            }
+        }
+    }
+
+    track_samples(&conv_conf->stats, y, conv_conf->total_samples);
+
+    free(u);
+    free(v);
+    free(rows);
+    return 0;
+}
+
+uint8_t factor_separable(const double* restrict h, size_t rows, size_t columns, double* restrict u, double* restrict v, uint8_t rounding_flag)
+{
+    size_t pivot = 0;
+
+    for (size_t n = 1; n < rows * columns; n++) {
+        pivot = fabs(h[n]) > fabs(h[pivot]) ? n : pivot;
+    }
+
+    const double peak = fabs(h[pivot]);
+    if (peak == 0.0) {
+        return 0;
+    }
+
+    /* A rank-1 matrix is the outer product of any of its non-zero columns and rows, the largest ones lose the least to rounding */
+    const size_t p = pivot / columns;
+    const size_t q = pivot % columns;
+    for (size_t m = 0; m < rows; m++) {
+        u[m] = h[m * columns + q];
+    }
+    for (size_t n = 0; n < columns; n++) {
+        v[n] = h[p * columns + n] / h[pivot];
+    }
+
+    /* The factors carry the rounding of the text they were read from, so a few steps of its last decimal can be allowed as long as they are small next to the peak */
+    double tolerance = SEPARABLE_TOLERANCE * peak;
+    if (rounding_flag) {
+        const double step = get_decimal_step(h, rows * columns);
+        if (step < 1.0 && step <= SEPARABLE_MAX_STEP * peak && SEPARABLE_STEPS * step > tolerance) {
+            tolerance = SEPARABLE_STEPS * step;
+        }
+    }
+
+    for (size_t m = 0; m < rows; m++) {
+        for (size_t n = 0; n < columns; n++) {
+            if (fabs(h[m * columns + n] - u[m] * v[n]) > tolerance) {
+                return 0;
+            }
+        }
+    }
+
+    return 1;
+}
+
+double get_decimal_step(const double* restrict x, size_t count)
+{
+    double scale = 1.0;
+
+    for (int d = 0; d <= DBL_DIG; d++) {
+        size_t i = 0;
+
+        /* Every value is a whole number of steps, give or take the error of parsing it */
+        while (i < count && fabs(x[i] * scale - nearbyint(x[i] * scale)) <= 1e-6) {
+            i++;
+        }
+        if (i == count) {
+            return 1.0 / scale;
+        }
+        scale *= 10.0;
+    }
+
+    return 0.0;
+}
+
+int set_matrix_output(conv_config_t* restrict conv_conf, double* restrict h)
+{
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const size_t columns_h = get_matrix_columns(info_h);
+
+    conv_conf->columns = get_matrix_columns(info_x) + columns_h - 1;
+    conv_conf->total_samples = (info_x->rows + info_h->rows - 1) * conv_conf->columns;
+    conv_conf->channels = 1;
+
+    if (conv_conf->conv_fcn) {
+        return 0;
+    }
+
+    double* u = malloc(info_h->rows * sizeof(double));
+    double* v = malloc(columns_h * sizeof(double));
+    if (!u || !v) {
+        fprintf(stderr, "\nUnable to allocate the factors of h[n].\n");
+        free(u);
+        free(v);
+
+        return 1;
+    }
+
+    /* Only exactly rank-1 kernels run as two 1-D passes, the others would change y[n] */
+    if (factor_separable(h, info_h->rows, columns_h, u, v, 0)) {
+        conv_conf->conv_fcn = &conv_separable_2d;
+    } else if (info_x->data_samples <= DIRECT_MAX_SAMPLES || info_h->data_samples <= DIRECT_MAX_SAMPLES) {
+        conv_conf->conv_fcn = &conv_direct;
+    } else {
+        conv_conf->conv_fcn = &conv_fft;
+    }
+
+    free(u);
+    free(v);
+    return 0;
+}
+
+size_t get_matrix_columns(input_info_t* restrict input_info)
+{
+    return input_info->data_samples / input_info->rows;
+}
+
+int conv_fft_transformed(conv_config_t* restrict conv_conf, fft_plan_t* restrict plan, spectra_t* restrict X, double* restrict h, double* restrict y)
+{
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+    const uint8_t channels_h = conv_conf->input_info[H_INDEX].channels;
+    const size_t size_y = conv_conf->total_samples;
+    const size_t N = plan->N;
+
+    spectra_t H = {0};
+    double complex* Y = malloc(N * sizeof(double complex));
+    int ret = 0;
+
+    /* Use the h[n] spectra made while x[n] was read when they match the plan */
+    if (conv_conf->spectra_h && conv_conf->spectra_h->N == N && conv_conf->spectra_h->pairs == X->pairs) {
+        H = *conv_conf->spectra_h;
+        free(conv_conf->spectra_h);
+        conv_conf->spectra_h = NULL;
+    } else {
+        ret = transform_channels(plan, get_input_samples(&conv_conf->input_info[H_INDEX], h), size_h, channels_h, conv_conf->channels, &H);
+    }
+
+    if (ret || !Y) {
+        fprintf(stderr, "\nUnable to transform h[n].\n");
+        free_spectra(&H);
+        free(Y);
+
+        return 1;
+    }
+
+    for (uint8_t p = 0; p < X->pairs; p++) {
+        const uint8_t c = 2 * p;
+
+        memset(Y, 0, N * sizeof(double complex));
+        multiply_spectra(Y, X->bins[p], X->shared[p], H.bins[p], H.shared[p], N);
+        fft(plan, Y, 1);
+        unpack_channel_pair(Y, N, y, size_y, conv_conf->channels, c, c + 1 < conv_conf->channels ? c + 1 : NO_CHANNEL, &conv_conf->stats);
+    }
+
+    free_spectra(&H);
+    free(Y);
+    return 0;
+}
+
+int conv_batch_h(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_x, double* restrict x)
+{
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const uint8_t fft_flag = conv_conf->conv_fcn == NULL || conv_conf->conv_fcn == &conv_fft;
+    fft_plan_t* plan = NULL;
+    spectra_t X = {0};
+    size_t done = 0;
+    size_t N = 0;
+
+    /* Size the transform for the longest h[n] known from probing, so x[n] is only transformed again for a longer CSV h[n] */
+    for (size_t b = 0; b < conv_conf->batch_count; b++) {
+        size_t size_y = info_x->data_samples + conv_conf->batch_info[b].data_samples - 1;
+        if (size_y > N) {
+            N = size_y;
+        }
+    }
+    N = nextpow2(N);
+
+    check_timer_start(conv_conf);
+
+    for (size_t b = 0; b < conv_conf->batch_count; b++) {
+        SF_INFO sf_info_h = {0};
+        double* h = NULL;
+        double* y = NULL;
+        int ret = 0;
+
+        *info_h = conv_conf->batch_info[b];
+        if (read_ir_input(conv_conf, &sf_info_h, &h)) {
+            fprintf(stderr, "Skipping h[n] input '%s'.\n", info_h->ibuff);
+            continue;
+        }
+
+        if (conv_conf->info_flag && !conv_conf->quiet_flag) {
+            fprintf(stdout, "\n--INFO--");
+            fprintf(stdout, "\n\t=H INPUT %zu/%zu=\n", b + 1, conv_conf->batch_count);
+            show_input_info(info_h, &sf_info_h);
+            fprintf(stdout, "---\n\n");
+        }
+
+        conv_conf->total_samples = info_x->data_samples + info_h->data_samples - 1;
+        conv_conf->channels = info_x->channels > info_h->channels ? info_x->channels : info_h->channels;
+        conv_conf->stats = (output_stats_t){0};
+        y = calloc(conv_conf->total_samples * conv_conf->channels, sizeof(double));
+        if (!y) {
+            fprintf(stderr, "\nUnable to allocate y[n] for h[n] input '%s'.\n", info_h->ibuff);
+            release_input(info_h, h);
+            destroy_partitioned_ir(conv_conf->ir);
+            conv_conf->ir = NULL;
+            continue;
+        }
+
+        if (conv_conf->ir) {
+            /* Cached h[n] spectra go through the block engine */
+            ret = conv_block(conv_conf, x, h, y);
+            destroy_partitioned_ir(conv_conf->ir);
+            conv_conf->ir = NULL;
+        } else if (fft_flag) {
+            /* Only transform x[n] again when the transform size or channel layout changes */
+            if (!plan || plan->N < nextpow2(conv_conf->total_samples) || X.channels != conv_conf->channels) {
+                if (nextpow2(conv_conf->total_samples) > N) {
+                    N = nextpow2(conv_conf->total_samples);
+                }
+                destroy_fft_plan(plan);
+                free_spectra(&X);
+                plan = create_fft_plan(N);
+                if (!plan || transform_channels(plan, get_input_samples(info_x, x), info_x->data_samples, info_x->channels, conv_conf->channels, &X)) {
+                    fprintf(stderr, "\nUnable to transform x[n].\n");
+                    release_input(info_h, h);
+                    free(y);
+                    break;
+                }
+            }
+            ret = conv_fft_transformed(conv_conf, plan, &X, h, y);
+        } else {
+            ret = conv_conf->conv_fcn(conv_conf, x, h, y);
+        }
+
+        /* Every output gets its own generated name */
+        conv_conf->ofile[0] = '\0';
+        if (!ret && !write_output(conv_conf, sf_info_x, &sf_info_h, y)) {
+            done++;
+        }
+
+        release_input(info_h, h);
+        free(y);
+    }
+
+    check_timer_end_output(conv_conf);
+
+    if (!conv_conf->quiet_flag) {
+        printf("Convolved x[n] with %zu of %zu h[n] inputs.\n", done, conv_conf->batch_count);
+    }
+
+    free_spectra(&X);
+    destroy_fft_plan(plan);
+    return done == conv_conf->batch_count ? 0 : 1;
+}
+
+int conv_block(conv_config_t* restrict conv_conf, double* restrict x, double* restrict h, double* restrict y)
+{
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+
+    /* Use the cached spectra if h[n] came from the cache */
+    partitioned_ir_t* ir = conv_conf->ir;
+    const size_t block_size = ir ? ir->block_size : get_block_size(conv_conf->block_size, size_h);
+
+    fft_plan_t* plan = create_fft_plan(2 * block_size);
+    if (plan && !ir) {
+        ir = partition_ir(plan, get_input_samples(&conv_conf->input_info[H_INDEX], h), size_h, conv_conf->input_info[H_INDEX].channels);
+    }
+    if (!plan || !ir) {
+        fprintf(stderr, "\nUnable to partition h[n] into blocks of %zu samples.\n", block_size);
+        destroy_fft_plan(plan);
+
+        return 1;
+    }
+
+    int ret = conv_block_partitioned(conv_conf, ir, plan, get_input_samples(&conv_conf->input_info[X_INDEX], x), y);
+
+    if (ir != conv_conf->ir) {
+        destroy_partitioned_ir(ir);
+    }
+    destroy_fft_plan(plan);
+    return ret;
+}
+
+size_t get_block_size(size_t block_size, size_t size_h)
+{
+    if (block_size) {
+        return nextpow2(block_size);
+    }
+
+    /* A single partition for short h[n], otherwise keep the FFT size moderate */
+    block_size = nextpow2(size_h);
+    if (block_size < BLOCK_MIN_SIZE) {
+        block_size = BLOCK_MIN_SIZE;
+    }
+    if (block_size > BLOCK_MAX_SIZE) {
+        block_size = BLOCK_MAX_SIZE;
+    }
+
+    return block_size;
+}
+
+partitioned_ir_t* partition_ir(fft_plan_t* restrict plan, samples_t h, size_t size_h, uint8_t channels)
+{
+    const size_t N = plan->N;
+    const size_t B = N / 2;
+
+    partitioned_ir_t* ir = calloc(1, sizeof(partitioned_ir_t));
+    double complex* Z = malloc(N * sizeof(double complex));
+    if (!ir || !Z) {
+        free(ir);
+        free(Z);
+
+        return NULL;
+    }
+
+    ir->block_size = B;
+    ir->partitions = (size_h + B - 1) / B;
+    ir->channels = channels;
+    ir->bins = malloc(ir->partitions * channels * (B + 1) * sizeof(double complex));
+    if (!ir->bins) {
+        free(ir);
+        free(Z);
+
+        return NULL;
+    }
+
+    for (size_t p = 0; p < ir->partitions; p++) {
+        const size_t frames = size_h - p * B < B ? size_h - p * B : B;
+
+        for (uint8_t c = 0; c < channels; c += 2) {
+            const uint8_t pair_flag = c + 1 < channels;
+
+            pack_channel_pair(Z, N, offset_samples(h, p * B * channels), frames, channels, c, pair_flag ? c + 1 : NO_CHANNEL);
+            fft(plan, Z, 0);
+            split_packed_spectrum(Z, N, get_partition(ir, p, c), pair_flag ? get_partition(ir, p, c + 1) : NULL);
+        }
+    }
+
+    free(Z);
+    return ir;
+}
+
+void destroy_partitioned_ir(partitioned_ir_t* ir)
+{
+    if (!ir) {
+        return;
+    }
+
+    if (ir->map.data) {
+        unmap_file(&ir->map);
+    } else {
+        free(ir->bins);
+    }
+    free(ir);
+}
+
+double complex* get_partition(partitioned_ir_t* ir, size_t partition, uint8_t channel)
+{
+    return ir->bins + (partition * ir->channels + channel) * (ir->block_size + 1);
+}
+
+void split_packed_spectrum(double complex* restrict Z, size_t N, double complex* restrict S0, double complex* restrict S1)
+{
+    /* A lone real channel is already its own spectrum */
+    if (!S1) {
+        memcpy(S0, Z, (N / 2 + 1) * sizeof(double complex));
+
+        return;
+    }
+
+    /* S0 = (Z[k] + Z*[N-k])/2 and S1 = (Z[k] - Z*[N-k])/2j */
+    for (size_t k = 0; k <= N / 2; k++) {
+        const size_t kc = (N - k) & (N - 1);
+        const double complex d = 0.5 * (Z[k] - conj(Z[kc]));
+
+        S0[k] = 0.5 * (Z[k] + conj(Z[kc]));
+        S1[k] = CMPLX(cimag(d), -creal(d));
+    }
+}
+
+void merge_packed_spectrum(double complex* restrict Z, size_t N, double complex* restrict S0, double complex* restrict S1)
+{
+    /* Z = S0 + jS1, with the upper half from conjugate symmetry of both channels */
+    for (size_t k = 0; k <= N / 2; k++) {
+        Z[k] = S1 ? S0[k] + CMPLX(-cimag(S1[k]), creal(S1[k])) : S0[k];
+    }
+
+    for (size_t k = N / 2 + 1; k < N; k++) {
+        const double complex s0 = conj(S0[N - k]);
+        const double complex s1 = S1 ? conj(S1[N - k]) : 0.0;
+
+        Z[k] = s0 + CMPLX(-cimag(s1), creal(s1));
+    }
+}
+
+block_conv_t* create_block_conv(partitioned_ir_t* restrict ir, fft_plan_t* restrict plan, ir_schedule_t* restrict schedule, uint8_t channels_x, uint8_t channels)
+{
+    const size_t B = ir->block_size;
+
+    block_conv_t* bc = calloc(1, sizeof(block_conv_t));
+    if (!bc) {
+        return NULL;
+    }
+
+    bc->ir = ir;
+    bc->plan = plan;
+    bc->schedule = schedule;
+    bc->channels_x = channels_x;
+    bc->channels = channels;
+    bc->slots = ir->partitions;
+    bc->fdl_pos = 0;
+    bc->position = 0;
+
+    /* Every h[n] of the schedule reads the one delay line, so it holds enough blocks for the longest */
+    if (schedule) {
+        for (size_t s = 0; s < schedule->count; s++) {
+            if (schedule->irs[s]->block_size != B) {
+                free(bc);
+
+                return NULL;
+            }
+            bc->slots = schedule->irs[s]->partitions > bc->slots ? schedule->irs[s]->partitions : bc->slots;
+        }
+
+        bc->weights = malloc((schedule->count + 1) * B * sizeof(double));
+        if (!bc->weights) {
+            free(bc);
+
+            return NULL;
+        }
+    }
+
+    bc->fdl = calloc(bc->slots * channels_x * (B + 1), sizeof(double complex));
+    bc->history = calloc(B * channels_x, sizeof(double));
+    bc->Z = malloc(2 * B * sizeof(double complex));
+    bc->acc = malloc(2 * (B + 1) * sizeof(double complex));
+    if (!bc->fdl || !bc->history || !bc->Z || !bc->acc) {
+        destroy_block_conv(bc);
+
+        return NULL;
+    }
+
+    return bc;
+}
+
+void destroy_block_conv(block_conv_t* bc)
+{
+    if (!bc) {
+        return;
+    }
+
+    free(bc->fdl);
+    free(bc->history);
+    free(bc->Z);
+    free(bc->acc);
+    free(bc->weights);
+    free(bc);
+}
+
+void process_block(block_conv_t* restrict bc, samples_t x_block, size_t frames, double* restrict y_block)
+{
+    const size_t B = bc->ir->block_size;
+    const size_t bins = B + 1;
+    const size_t N = bc->plan->N;
+    const size_t S = bc->slots;
+    const uint8_t cx = bc->channels_x;
+    const double scale = 1.0 / N;
+    double complex* Z = bc->Z;
+
+    /* The newest block takes the slot before the previous one, so partition p pairs with slot (fdl_pos + p) % S */
+    bc->fdl_pos = (bc->fdl_pos + S - 1) % S;
+
+    /* Transform the previous and current block, each pair of x[n] channels shares one FFT */
+    for (uint8_t c = 0; c < cx; c += 2) {
+        const uint8_t pair_flag = c + 1 < cx;
+
+        for (size_t n = 0; n < B; n++) {
+            Z[n] = CMPLX(bc->history[n * cx + c], pair_flag ? bc->history[n * cx + c + 1] : 0.0);
+        }
+        for (size_t n = 0; n < B; n++) {
+            Z[B + n] = n < frames ? CMPLX(get_sample(x_block, n * cx + c), pair_flag ? get_sample(x_block, n * cx + c + 1) : 0.0) : 0.0;
+        }
+
+        fft(bc->plan, Z, 0);
+        split_packed_spectrum(Z, N, bc->fdl + (bc->fdl_pos * cx + c) * bins, pair_flag ? bc->fdl + (bc->fdl_pos * cx + c + 1) * bins : NULL);
+    }
+
+    /* Keep the current block for the next overlap */
+    for (size_t i = 0; i < frames * cx; i++) {
+        bc->history[i] = get_sample(x_block, i);
+    }
+    memset(bc->history + frames * cx, 0, (B - frames) * cx * sizeof(double));
+
+    if (bc->schedule) {
+        mix_scheduled_block(bc, y_block);
+        bc->position += B;
+
+        return;
+    }
+
+    /* Multiply-accumulate every partition, each pair of output channels shares one inverse FFT */
+    for (uint8_t c = 0; c < bc->channels; c += 2) {
+        const uint8_t pair_flag = c + 1 < bc->channels;
+
+        accumulate_partitions(bc, bc->ir, c, bc->acc);
+        if (pair_flag) {
+            accumulate_partitions(bc, bc->ir, c + 1, bc->acc + bins);
+        }
+
+        merge_packed_spectrum(Z, N, bc->acc, pair_flag ? bc->acc + bins : NULL);
+        fft(bc->plan, Z, 1);
+
+        /* Overlap-save keeps the second half */
+        for (size_t n = 0; n < B; n++) {
+            y_block[n * bc->channels + c] = creal(Z[B + n]) * scale;
+            if (pair_flag) {
+                y_block[n * bc->channels + c + 1] = cimag(Z[B + n]) * scale;
+            }
+        }
+    }
+    bc->position += B;
+}
+
+void accumulate_partitions(block_conv_t* restrict bc, partitioned_ir_t* restrict ir, uint8_t channel, double complex* restrict acc)
+{
+    const size_t bins = ir->block_size + 1;
+    const uint8_t cx = bc->channels_x;
+
+    memset(acc, 0, bins * sizeof(double complex));
+    for (size_t p = 0; p < ir->partitions; p++) {
+        double complex* X = bc->fdl + ((((bc->fdl_pos + p) % bc->slots) * cx) + channel % cx) * bins;
+        double complex* H = get_partition(ir, p, channel % ir->channels);
+
+        for (size_t k = 0; k < bins; k++) {
+            acc[k] += complex_mul(X[k], H[k]);
+        }
+    }
+}
+
+void mix_scheduled_block(block_conv_t* restrict bc, double* restrict y_block)
+{
+    const ir_schedule_t* schedule = bc->schedule;
+    const size_t B = bc->ir->block_size;
+    const size_t bins = B + 1;
+    const size_t N = bc->plan->N;
+    const uint8_t channels = bc->channels;
+    const double scale = 1.0 / N;
+    double complex* Z = bc->Z;
+    size_t first = 0;
+    size_t last = 0;
+
+    /* An h[n] faded in by the start of the block silences the ones before it, and one starting after the block is not heard yet */
+    for (size_t i = 1; i <= schedule->count; i++) {
+        first = schedule->starts[i - 1] + schedule->fade <= bc->position ? i : first;
+        last = schedule->starts[i - 1] < bc->position + B ? i : last;
+    }
+
+    set_schedule_weights(bc, first, last);
+    memset(y_block, 0, B * channels * sizeof(double));
+
+    /* Every output channel of every h[n] heard, two of them share one inverse FFT whatever h[n] they come from */
+    const size_t outputs = (last - first + 1) * channels;
+    for (size_t j = 0; j < outputs; j += 2) {
+        const uint8_t pair_flag = j + 1 < outputs;
+
+        for (uint8_t q = 0; q <= pair_flag; q++) {
+            const size_t i = first + (j + q) / channels;
+
+            accumulate_partitions(bc, i ? schedule->irs[i - 1] : bc->ir, (j + q) % channels, bc->acc + q * bins);
+        }
+
+        merge_packed_spectrum(Z, N, bc->acc, pair_flag ? bc->acc + bins : NULL);
+        fft(bc->plan, Z, 1);
+
+        /* Overlap-save keeps the second half, scaled by the gain of its h[n] */
+        for (uint8_t q = 0; q <= pair_flag; q++) {
+            const double* weights = bc->weights + ((j + q) / channels) * B;
+            const uint8_t c = (j + q) % channels;
+
+            for (size_t n = 0; n < B; n++) {
+                y_block[n * channels + c] += weights[n] * (q ? cimag(Z[B + n]) : creal(Z[B + n])) * scale;
+            }
+        }
+    }
+}
+
+void set_schedule_weights(block_conv_t* restrict bc, size_t first, size_t last)
+{
+    const size_t B = bc->ir->block_size;
+
+    for (size_t n = 0; n < B; n++) {
+        double rest = 1.0;
+
+        /* Later h[n] take their gain from what is left by the ones after them, the first one heard has the rest */
+        for (size_t i = last; i > first; i--) {
+            const double gain = get_fade_gain(bc->schedule, i - 1, bc->position + n);
+
+            bc->weights[(i - first) * B + n] = gain * rest;
+            rest *= 1.0 - gain;
+        }
+        bc->weights[n] = rest;
+    }
+}
+
+double get_fade_gain(const ir_schedule_t* restrict schedule, size_t entry, size_t frame)
+{
+    const size_t start = schedule->starts[entry];
+
+    if (frame < start) {
+        return 0.0;
+    }
+
+    return frame - start >= schedule->fade ? 1.0 : (double)(frame - start) / schedule->fade;
+}
+
+int read_schedule_file(conv_config_t* restrict conv_conf, char* restrict schedule_file)
+{
+    ir_schedule_t* schedule = &conv_conf->schedule;
+    char line[MAX_STR + MIN_STR];
+
+    FILE* file = fopen(schedule_file, "r");
+    if (!file) {
+        fprintf(stderr, "\nUnable to open h[n] schedule '%s'.\n", schedule_file);
+
+        return 1;
+    }
+
+    while (fgets(line, sizeof(line), file)) {
+        double time = 0.0;
+        int offset = 0;
+
+        line[strcspn(line, "\r\n")] = '\0';
+        if (line[0] == '\0') {
+            continue;
+        }
+
+        if (sscanf(line, "%lf %n", &time, &offset) != 1 || !offset || line[offset] == '\0' || time < 0.0) {
+            fprintf(stderr, "\nSchedule line '%s' needs a time in seconds followed by an h[n] input.\n", line);
+            fclose(file);
+
+            return 1;
+        }
+
+        if (schedule->count && time <= schedule->times[schedule->count - 1]) {
+            fprintf(stderr, "\nSchedule times have to increase from line to line, '%s' does not.\n", line);
+            fclose(file);
+
+            return 1;
+        }
+
+        double* times = realloc(schedule->times, (schedule->count + 1) * sizeof(double));
+        if (times) {
+            schedule->times = times;
+        }
+        input_info_t* inputs = realloc(schedule->inputs, (schedule->count + 1) * sizeof(input_info_t));
+        if (inputs) {
+            schedule->inputs = inputs;
+        }
+        if (!times || !inputs) {
+            fprintf(stderr, "\nUnable to allocate the h[n] schedule.\n");
+            fclose(file);
+
+            return 1;
+        }
+
+        input_info_t* input_info = &schedule->inputs[schedule->count];
+        memset(input_info, 0, sizeof(input_info_t));
+        if (strlen(line + offset) > MAX_STR - 1) {
+            fprintf(stderr, "Argument string length was too large. Max is %d.\n", MAX_STR);
+            fclose(file);
+
+            return 1;
+        }
+        strcpy(input_info->ibuff, line + offset);
+        if (get_input_type(input_info)) {
+            fclose(file);
+
+            return 1;
+        }
+
+        /* A schedule can name more files than may be open at once */
+        close_probe(input_info);
+        unmap_file(&input_info->map);
+        input_info->samples.data = NULL;
+
+        schedule->times[schedule->count] = time;
+        schedule->count++;
+    }
+
+    fclose(file);
+
+    if (!schedule->count) {
+        fprintf(stderr, "\nNo h[n] inputs found in schedule '%s'.\n", schedule_file);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int read_ir_schedule(conv_config_t* restrict conv_conf)
+{
+    ir_schedule_t* schedule = &conv_conf->schedule;
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const double samplerate = info_x->input_type == AUDIO_TYPE_CHAR && info_x->probe_info.samplerate ? info_x->probe_info.samplerate : RAW_SAMPLERATE;
+    int ret = 0;
+
+    /* Every h[n] has to share the block size of the engine, which is picked from the first */
+    const size_t block_size = conv_conf->ir ? conv_conf->ir->block_size : get_block_size(conv_conf->block_size, info_h->data_samples);
+
+    fft_plan_t* plan = create_fft_plan(2 * block_size);
+    schedule->starts = malloc(schedule->count * sizeof(size_t));
+    schedule->irs = calloc(schedule->count, sizeof(partitioned_ir_t*));
+    if (!plan || !schedule->starts || !schedule->irs) {
+        fprintf(stderr, "\nUnable to allocate the h[n] schedule.\n");
+        destroy_fft_plan(plan);
+
+        return 1;
+    }
+
+    schedule->fade = llround((conv_conf->crossfade < 0.0 ? SCHEDULE_CROSSFADE_MS / 1000.0 : conv_conf->crossfade) * samplerate);
+    schedule->size_h = 0;
+    schedule->channels = 0;
+
+    for (size_t s = 0; s < schedule->count && !ret; s++) {
+        input_info_t* info = &schedule->inputs[s];
+        SF_INFO sf_info = {0};
+        double* h = NULL;
+
+        ret = info->inp(info, &sf_info, &h);
+        if (ret) {
+            break;
+        }
+
+        schedule->starts[s] = llround(schedule->times[s] * samplerate);
+        schedule->irs[s] = partition_ir(plan, get_input_samples(info, h), info->data_samples, info->channels);
+        schedule->size_h = info->data_samples > schedule->size_h ? info->data_samples : schedule->size_h;
+        schedule->channels = info->channels > schedule->channels ? info->channels : schedule->channels;
+        release_input(info, h);
+
+        if (!schedule->irs[s]) {
+            fprintf(stderr, "\nUnable to partition scheduled h[n] '%s' into blocks of %zu samples.\n", info->ibuff, block_size);
+            ret = 1;
+        }
+    }
+
+    destroy_fft_plan(plan);
+
+    if (!ret && !conv_conf->quiet_flag) {
+        printf("Partitioned %zu scheduled h[n] inputs, crossfading over %zu samples.\n", schedule->count, schedule->fade);
+    }
+
+    return ret;
+}
+
+size_t get_ir_frames(conv_config_t* restrict conv_conf)
+{
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+
+    return conv_conf->schedule.size_h > size_h ? conv_conf->schedule.size_h : size_h;
+}
+
+uint8_t get_ir_channels(conv_config_t* restrict conv_conf)
+{
+    const uint8_t channels_h = conv_conf->input_info[H_INDEX].channels;
+
+    return conv_conf->schedule.channels > channels_h ? conv_conf->schedule.channels : channels_h;
+}
+
+int conv_block_partitioned(conv_config_t* restrict conv_conf, partitioned_ir_t* restrict ir, fft_plan_t* restrict plan, samples_t x, double* restrict y)
+{
+    const size_t size_x = conv_conf->input_info[X_INDEX].data_samples;
+    const uint8_t channels_x = conv_conf->input_info[X_INDEX].channels;
+    const size_t size_y = conv_conf->total_samples;
+    const uint8_t channels = conv_conf->channels;
+    const size_t B = ir->block_size;
+
+    block_conv_t* bc = create_block_conv(ir, plan, conv_conf->schedule.count ? &conv_conf->schedule : NULL, channels_x, channels);
+    double* y_block = malloc(B * channels * sizeof(double));
+    if (!bc || !y_block) {
+        fprintf(stderr, "\nUnable to allocate the block engine state.\n");
+        destroy_block_conv(bc);
+        free(y_block);
+
+        return 1;
+    }
+
+    for (size_t start = 0; start < size_y; start += B) {
+        const size_t frames = start < size_x ? (size_x - start < B ? size_x - start : B) : 0;
+        const size_t out_frames = size_y - start < B ? size_y - start : B;
+
+        process_block(bc, frames ? offset_samples(x, start * channels_x) : x, frames, y_block);
+        for (size_t i = 0; i < out_frames * channels; i++) {
+            y[start * channels + i] = y_block[i];
+            track_sample(&conv_conf->stats, y_block[i]);
+        }
+    }
+
+    destroy_block_conv(bc);
+    free(y_block);
+    return 0;
+}
+
+int conv_batch_x(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_h, double* restrict h)
+{
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const size_t block_size = conv_conf->ir ? conv_conf->ir->block_size : get_block_size(conv_conf->block_size, info_h->data_samples);
+    uint16_t threads = conv_conf->threads ? conv_conf->threads : get_cpu_count();
+    struct timespec start_time;
+    struct timespec end_time;
+
+    if (threads > conv_conf->batch_count) {
+        threads = conv_conf->batch_count;
+    }
+
+    batch_context_t ctx = {
+        .conv_conf = conv_conf,
+        .sf_info_h = sf_info_h,
+        .next = 0,
+        .done = 0,
+        .samples = 0,
+    };
+
+    /* Partition and transform h[n] once for every worker, unless it came from the cache */
+    ctx.plan = create_fft_plan(2 * block_size);
+    ctx.ir = conv_conf->ir;
+    if (ctx.plan && !ctx.ir) {
+        ctx.ir = partition_ir(ctx.plan, get_input_samples(info_h, h), info_h->data_samples, info_h->channels);
+    }
+    if (!ctx.plan || !ctx.ir) {
+        fprintf(stderr, "\nUnable to partition h[n] into blocks of %zu samples.\n", block_size);
+        destroy_fft_plan(ctx.plan);
+
+        return 1;
+    }
+
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    if (!workers) {
+        if (ctx.ir != conv_conf->ir) {
+            destroy_partitioned_ir(ctx.ir);
+        }
+        destroy_fft_plan(ctx.plan);
+
+        return 1;
+    }
+
+    pthread_mutex_init(&ctx.lock, NULL);
+    timespec_get(&start_time, TIME_UTC);
+
+    /* Files are read, convolved, and written by every worker, so the stages of different files overlap */
+    uint16_t started = 0;
+    for (; started < threads; started++) {
+        if (pthread_create(&workers[started], NULL, &batch_x_worker, &ctx)) {
+            break;
+        }
+    }
+
+    /* Fall back to the calling thread if none could be started */
+    if (!started) {
+        batch_x_worker(&ctx);
+    }
+
+    for (uint16_t t = 0; t < started; t++) {
+        pthread_join(workers[t], NULL);
+    }
+
+    timespec_get(&end_time, TIME_UTC);
+    const double time_taken = (end_time.tv_sec - start_time.tv_sec) + ((end_time.tv_nsec - start_time.tv_nsec) / 1e9);
+
+    if (!conv_conf->quiet_flag) {
+        printf("Convolved %zu of %zu x[n] inputs with %u threads in %.3lf seconds.\n", ctx.done, conv_conf->batch_count, started ? started : 1, time_taken);
+        printf("Throughput: %.2lf files/s, %.0lf samples/s.\n", ctx.done / time_taken, ctx.samples / time_taken);
+    }
+
+    pthread_mutex_destroy(&ctx.lock);
+    free(workers);
+    if (ctx.ir != conv_conf->ir) {
+        destroy_partitioned_ir(ctx.ir);
+    }
+    destroy_fft_plan(ctx.plan);
+    return ctx.done == conv_conf->batch_count ? 0 : 1;
+}
+
+void* batch_x_worker(void* arg)
+{
+    batch_context_t* ctx = arg;
+
+    for (;;) {
+        pthread_mutex_lock(&ctx->lock);
+        const size_t b = ctx->next++;
+        pthread_mutex_unlock(&ctx->lock);
+
+        if (b >= ctx->conv_conf->batch_count) {
+            break;
+        }
+
+        /* Every worker keeps its own copy of the config for the sizes and the output name */
+        conv_config_t conv_conf = *ctx->conv_conf;
+        input_info_t* info_x = &conv_conf.input_info[X_INDEX];
+        input_info_t* info_h = &conv_conf.input_info[H_INDEX];
+        SF_INFO sf_info_x = {0};
+        double* x = NULL;
+
+        *info_x = ctx->conv_conf->batch_info[b];
+
+        if (info_x->inp(info_x, &sf_info_x, &x)) {
+            fprintf(stderr, "Skipping x[n] input '%s'.\n", info_x->ibuff);
+            release_input(info_x, x);
+            continue;
+        }
+
+        conv_conf.total_samples = info_x->data_samples + info_h->data_samples - 1;
+        conv_conf.channels = info_x->channels > info_h->channels ? info_x->channels : info_h->channels;
+
+        double* y = calloc(conv_conf.total_samples * conv_conf.channels, sizeof(double));
+        if (!y || conv_block_partitioned(&conv_conf, ctx->ir, ctx->plan, get_input_samples(info_x, x), y)) {
+            fprintf(stderr, "Skipping x[n] input '%s'.\n", info_x->ibuff);
+            release_input(info_x, x);
+            free(y);
+            continue;
+        }
+
+        /* The name generation uses static buffers */
+        pthread_mutex_lock(&ctx->lock);
+        conv_conf.ofile[0] = '\0';
+        generate_file_name(conv_conf.ofile, conv_conf.input_info, conv_conf.input_flag, conv_conf.out_extension);
+        pthread_mutex_unlock(&ctx->lock);
+
+        const int ret = write_output(&conv_conf, &sf_info_x, ctx->sf_info_h, y);
+
+        pthread_mutex_lock(&ctx->lock);
+        if (!ret) {
+            ctx->done++;
+            ctx->samples += info_x->data_samples * info_x->channels;
+        }
+        pthread_mutex_unlock(&ctx->lock);
+
+        release_input(info_x, x);
+        free(y);
+    }
+
+    return NULL;
+}
+
+int conv_stream(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_h, double* restrict h)
+{
+    SF_INFO sf_info_x = {0};
+    SNDFILE* file_x = NULL;
+    SNDFILE* file_y = NULL;
+
+    CHECK_RET(open_stream_input(conv_conf, sf_info_h, &sf_info_x, &file_x));
+    if ((conv_conf->norm_bound_flag && set_norm_bound(conv_conf, NULL, NULL, NULL, h)) || open_stream_output(conv_conf, &sf_info_x, &file_y)) {
+        sf_close(file_x);
+
+        return 1;
+    }
+
+    int ret = run_block_pipeline(conv_conf, h, file_x, file_y, conv_conf->out_subtype ? conv_conf->out_subtype : sf_info_x.format & SF_FORMAT_SUBMASK, 1);
+
+    sf_close(file_x);
+    sf_close(file_y);
+    return ret;
+}
+
+int conv_pipeline(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_h, double* restrict h)
+{
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    SF_INFO sf_info_x = {0};
+    SNDFILE* file_x = NULL;
+
+    CHECK_RET(open_input_file(info_x, &file_x, &sf_info_x));
+    info_x->channels = sf_info_x.channels;
+
+    if (conv_conf->norm_bound_flag && set_norm_bound(conv_conf, file_x, NULL, NULL, h)) {
+        sf_close(file_x);
+
+        return 1;
+    }
+
+    SF_INFO sf_info_y = sf_info_x;
+    sf_info_y.channels = info_x->channels > get_ir_channels(conv_conf) ? info_x->channels : get_ir_channels(conv_conf);
+    if (set_output_format(conv_conf, &sf_info_y)) {
+        sf_close(file_x);
+
+        return 1;
+    }
+
+    generate_file_name(conv_conf->ofile, conv_conf->input_info, conv_conf->input_flag, conv_conf->out_extension);
+    SNDFILE* file_y = sf_open(conv_conf->ofile, SFM_WRITE, &sf_info_y);
+    if (!(file_y)) {
+        fprintf(stderr, "%s\n", sf_strerror(file_y));
+        sf_close(file_x);
+
+        return 1;
+    }
+
+    int ret = run_block_pipeline(conv_conf, h, file_x, file_y, sf_info_y.format & SF_FORMAT_SUBMASK, 0);
+
+    sf_close(file_x);
+    sf_close(file_y);
+    if (!ret) {
+        printf("Saved result to '%s'.\n", conv_conf->ofile);
+    }
+    return ret;
+}
+
+uint8_t check_pipeline(conv_config_t* restrict conv_conf)
+{
+    const uint8_t block_flag = conv_conf->conv_fcn == &conv_block || (conv_conf->conv_fcn == NULL && conv_conf->cache_dir[0] != '\0');
+
+    /* Normalising needs all of y[n] before the first block is written */
+    return block_flag && !conv_conf->norm_flag && !conv_conf->batch_count && !conv_conf->stream_flag && !conv_conf->mem_limit &&
+        conv_conf->input_info[X_INDEX].input_type == AUDIO_TYPE_CHAR &&
+        (conv_conf->outp == NULL || conv_conf->outp == &output_file_audio);
+}
+
+int run_block_pipeline(conv_config_t* restrict conv_conf, double* restrict h, SNDFILE* restrict file_x, SNDFILE* restrict file_y, int format, uint8_t flush_flag)
+{
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const uint8_t channels_x = conv_conf->input_info[X_INDEX].channels;
+    pipeline_t pl = {0};
+    pthread_t reader;
+    pthread_t writer;
+    int ret = 1;
+
+    conv_conf->channels = channels_x > get_ir_channels(conv_conf) ? channels_x : get_ir_channels(conv_conf);
+
+    /* Use the cached spectra if h[n] came from the cache */
+    partitioned_ir_t* ir = conv_conf->ir;
+    const size_t block_size = ir ? ir->block_size : get_block_size(conv_conf->block_size, info_h->data_samples);
+
+    fft_plan_t* plan = create_fft_plan(2 * block_size);
+    if (plan && !ir) {
+        ir = partition_ir(plan, get_input_samples(info_h, h), info_h->data_samples, info_h->channels);
+    }
+
+    pl.conv_conf = conv_conf;
+    pl.file_x = file_x;
+    pl.file_y = file_y;
+    /* Only the stdout stream flushes, and it keeps the full scale of the clipping conversion it always had */
+    pl.quantizer = file_y ? create_quantizer(format, flush_flag) : NULL;
+    pl.flush_flag = flush_flag;
+    pl.bc = plan && ir ? create_block_conv(ir, plan, conv_conf->schedule.count ? &conv_conf->schedule : NULL, channels_x, conv_conf->channels) : NULL;
+    pl.x_ring = create_block_ring(PIPELINE_SLOTS, block_size * channels_x);
+    pl.y_ring = create_block_ring(PIPELINE_SLOTS, block_size * conv_conf->channels);
+    if (!pl.bc || !pl.x_ring || !pl.y_ring || (file_y && !pl.quantizer)) {
+        fprintf(stderr, "\nUnable to allocate the block engine state.\n");
+    } else if (pthread_create(&reader, NULL, pipeline_reader, &pl)) {
+        fprintf(stderr, "\nUnable to start the pipeline.\n");
+    } else {
+        if (pthread_create(&writer, NULL, pipeline_writer, &pl)) {
+            fprintf(stderr, "\nUnable to start the pipeline.\n");
+            ring_abort(pl.x_ring);
+            pthread_join(reader, NULL);
+        } else {
+            pl.ret[COMPUTE_STAGE] = pipeline_compute(&pl);
+            pthread_join(reader, NULL);
+            pthread_join(writer, NULL);
+
+            ret = pl.ret[READ_STAGE] || pl.ret[COMPUTE_STAGE] || pl.ret[WRITE_STAGE];
+            if (!ret && conv_conf->timer_flag) {
+                report_pipeline(&pl, conv_conf->stream_flag ? stderr : stdout);
+            }
+            if (!ret && (conv_conf->stream_flag || !conv_conf->quiet_flag)) {
+                show_output_level(conv_conf, conv_conf->stream_flag ? stderr : stdout);
+            }
+            if (!ret && pl.quantizer) {
+                report_clipping(pl.quantizer);
+            }
+        }
+    }
+
+    destroy_quantizer(pl.quantizer);
+    destroy_block_ring(pl.x_ring);
+    destroy_block_ring(pl.y_ring);
+    destroy_block_conv(pl.bc);
+    if (ir != conv_conf->ir) {
+        destroy_partitioned_ir(ir);
+    }
+    destroy_fft_plan(plan);
+    return ret;
+}
+
+void* pipeline_reader(void* arg)
+{
+    pipeline_t* pl = arg;
+    const size_t B = pl->bc->ir->block_size;
+    struct timespec start;
+    size_t frames = 0;
+    double* slot = NULL;
+
+    do {
+        slot = ring_write_slot(pl->x_ring);
+        if (!slot) {
+            pl->ret[READ_STAGE] = 1;
+
+            break;
+        }
+
+        timespec_get(&start, TIME_UTC);
+        frames = read_stream_block(pl->file_x, slot, B, pl->bc->channels_x);
+        pl->seconds[READ_STAGE] += get_seconds_since(&start);
+        pl->frames[READ_STAGE] += frames;
+
+        ring_push(pl->x_ring, frames);
+    } while (frames == B);
+
+    return NULL;
+}
+
+int pipeline_compute(pipeline_t* pl)
+{
+    const size_t B = pl->bc->ir->block_size;
+    const size_t size_h = get_ir_frames(pl->conv_conf);
+    struct timespec start;
+    size_t size_x = 0;
+    size_t written = 0;
+    size_t frames = 0;
+    size_t out_frames = 0;
+
+    /* Every x[n] block gives a finished y[n] block straight away */
+    do {
+        double* x_block = ring_read_slot(pl->x_ring, &frames);
+        double* y_block = x_block ? ring_write_slot(pl->y_ring) : NULL;
+        if (!y_block) {
+            ring_abort(pl->x_ring);
+            ring_abort(pl->y_ring);
+
+            return 1;
+        }
+
+        /* A short block is the end of x[n], the output stops at the end of y[n] */
+        out_frames = frames == B ? B : frames + (size_h - 1 < B - frames ? size_h - 1 : B - frames);
+        size_x += frames;
+
+        timespec_get(&start, TIME_UTC);
+        if (frames) {
+            process_block(pl->bc, double_samples(x_block), frames, y_block);
+        }
+        pl->seconds[COMPUTE_STAGE] += get_seconds_since(&start);
+
+        ring_pop(pl->x_ring);
+        if (frames) {
+            ring_push(pl->y_ring, out_frames);
+            written += out_frames;
+        }
+    } while (frames == B);
+
+    /* Flush the h[n] tail, ending with a short block. An exact multiple of blocks ends with an empty one */
+    const size_t size_y = size_x ? size_x + size_h - 1 : 0;
+    do {
+        double* y_block = ring_write_slot(pl->y_ring);
+        if (!y_block) {
+            return 1;
+        }
+
+        out_frames = size_y - written < B ? size_y - written : B;
+
+        timespec_get(&start, TIME_UTC);
+        if (out_frames) {
+            process_block(pl->bc, double_samples(NULL), 0, y_block);
+        }
+        pl->seconds[COMPUTE_STAGE] += get_seconds_since(&start);
+
+        ring_push(pl->y_ring, out_frames);
+        written += out_frames;
+    } while (out_frames == B);
+
+    pl->frames[COMPUTE_STAGE] = size_x;
+    pl->conv_conf->total_samples = size_y;
+
+    if (!size_x) {
+        fprintf(stderr, "\nNo x[n] samples were read.\n");
+
+        return 1;
+    }
+
+    return 0;
+}
+
+void* pipeline_writer(void* arg)
+{
+    pipeline_t* pl = arg;
+    const size_t B = pl->bc->ir->block_size;
+    struct timespec start;
+    size_t frames = 0;
+
+    do {
+        double* y_block = ring_read_slot(pl->y_ring, &frames);
+        if (!y_block) {
+            pl->ret[WRITE_STAGE] = 1;
+
+            break;
+        }
+
+        timespec_get(&start, TIME_UTC);
+        if (frames && write_stream_block(pl->conv_conf, pl->file_y, pl->quantizer, y_block, frames, pl->flush_flag)) {
+            pl->ret[WRITE_STAGE] = 1;
+            ring_abort(pl->x_ring);
+            ring_abort(pl->y_ring);
+
+            break;
+        }
+        pl->seconds[WRITE_STAGE] += get_seconds_since(&start);
+        pl->frames[WRITE_STAGE] += frames;
+
+        ring_pop(pl->y_ring);
+    } while (frames == B);
+
+    return NULL;
+}
+
+void report_pipeline(pipeline_t* pl, FILE* file)
+{
+    const char* names[PIPELINE_STAGES] = {"Read", "Convolve", "Write"};
+
+    for (uint8_t s = 0; s < PIPELINE_STAGES; s++) {
+        fprintf(file, "%s stage: %zu frames in %.9lf seconds, %.0lf frames/s.\n", names[s], pl->frames[s], pl->seconds[s], pl->seconds[s] > 0.0 ? pl->frames[s] / pl->seconds[s] : 0.0);
+    }
+}
+
+block_ring_t* create_block_ring(size_t slots, size_t block_samples)
+{
+    block_ring_t* ring = calloc(1, sizeof(block_ring_t));
+    if (!ring) {
+        return NULL;
+    }
+
+    ring->slots = slots;
+    ring->block_samples = block_samples;
+    ring->blocks = malloc(slots * block_samples * sizeof(double));
+    ring->frames = calloc(slots, sizeof(size_t));
+    if (!ring->blocks || !ring->frames) {
+        free(ring->blocks);
+        free(ring->frames);
+        free(ring);
+
+        return NULL;
+    }
+
+    pthread_mutex_init(&ring->lock, NULL);
+    pthread_cond_init(&ring->filled, NULL);
+    pthread_cond_init(&ring->drained, NULL);
+
+    return ring;
+}
+
+void destroy_block_ring(block_ring_t* ring)
+{
+    if (!ring) {
+        return;
+    }
+
+    pthread_mutex_destroy(&ring->lock);
+    pthread_cond_destroy(&ring->filled);
+    pthread_cond_destroy(&ring->drained);
+    free(ring->blocks);
+    free(ring->frames);
+    free(ring);
+}
+
+double* ring_write_slot(block_ring_t* ring)
+{
+    pthread_mutex_lock(&ring->lock);
+    while (ring->count == ring->slots && !ring->abort_flag) {
+        pthread_cond_wait(&ring->drained, &ring->lock);
+    }
+
+    double* slot = ring->abort_flag ? NULL : ring->blocks + ((ring->head + ring->count) % ring->slots) * ring->block_samples;
+    pthread_mutex_unlock(&ring->lock);
+
+    return slot;
+}
+
+void ring_push(block_ring_t* ring, size_t frames)
+{
+    pthread_mutex_lock(&ring->lock);
+    ring->frames[(ring->head + ring->count) % ring->slots] = frames;
+    ring->count++;
+    pthread_cond_signal(&ring->filled);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+double* ring_read_slot(block_ring_t* ring, size_t* frames)
+{
+    pthread_mutex_lock(&ring->lock);
+    while (ring->count == 0 && !ring->abort_flag) {
+        pthread_cond_wait(&ring->filled, &ring->lock);
+    }
+
+    double* slot = ring->abort_flag ? NULL : ring->blocks + ring->head * ring->block_samples;
+    *frames = ring->frames[ring->head];
+    pthread_mutex_unlock(&ring->lock);
+
+    return slot;
+}
+
+void ring_pop(block_ring_t* ring)
+{
+    pthread_mutex_lock(&ring->lock);
+    ring->head = (ring->head + 1) % ring->slots;
+    ring->count--;
+    pthread_cond_signal(&ring->drained);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+void ring_abort(block_ring_t* ring)
+{
+    pthread_mutex_lock(&ring->lock);
+    ring->abort_flag = 1;
+    pthread_cond_broadcast(&ring->filled);
+    pthread_cond_broadcast(&ring->drained);
+    pthread_mutex_unlock(&ring->lock);
+}
+
+int open_stream_input(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_h, SF_INFO* restrict sf_info_x, SNDFILE** restrict file)
+{
+    memset(sf_info_x, 0, sizeof(SF_INFO));
+
+    /* Raw samples have no header to describe them */
+    if (conv_conf->raw_format) {
+        sf_info_x->format = SF_FORMAT_RAW | conv_conf->raw_format;
+        sf_info_x->channels = conv_conf->raw_channels;
+        sf_info_x->samplerate = sf_info_h->samplerate ? sf_info_h->samplerate : RAW_SAMPLERATE;
+    }
+
+#ifdef _WIN32
+    _setmode(_fileno(stdin), _O_BINARY);
+#endif
+
+    *file = sf_open_fd(fileno(stdin), SFM_READ, sf_info_x, 0);
+    if (!(*file)) {
+        fprintf(stderr, "\nUnable to read x[n] from stdin. %s\n", sf_strerror(NULL));
+
+        return 1;
+    }
+
+    if (sf_info_x->channels > UINT8_MAX) {
+        fprintf(stderr, "\nToo many channels in the x[n] stream.\n");
+        sf_close(*file);
+
+        return 1;
+    }
+
+    conv_conf->input_info[X_INDEX].channels = sf_info_x->channels;
+
+    return 0;
+}
+
+int open_stream_output(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_x, SNDFILE** restrict file)
+{
+    SF_INFO sf_info_y = *sf_info_x;
+
+    *file = NULL;
+
+    if (!conv_conf->raw_format) {
+        return 0;
+    }
+
+#ifdef _WIN32
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+
+    /* Fixed-point outputs clip instead of wrapping around */
+    sf_info_y.channels = conv_conf->input_info[X_INDEX].channels > conv_conf->input_info[H_INDEX].channels ? conv_conf->input_info[X_INDEX].channels : conv_conf->input_info[H_INDEX].channels;
+    CHECK_RET(set_output_format(conv_conf, &sf_info_y));
+    *file = sf_open_fd(fileno(stdout), SFM_WRITE, &sf_info_y, 0);
+    if (!(*file)) {
+        fprintf(stderr, "\nUnable to write y[n] to stdout. %s\n", sf_strerror(NULL));
+
+        return 1;
+    }
+    sf_command(*file, SFC_SET_CLIPPING, NULL, SF_TRUE);
+
+    return 0;
+}
+
+size_t read_stream_block(SNDFILE* restrict file, double* restrict x_block, size_t frames, uint8_t channels)
+{
+    size_t total = 0;
+    sf_count_t count = 0;
+
+    while (total < frames && (count = sf_readf_double(file, x_block + total * channels, frames - total)) > 0) {
+        total += count;
+    }
+
+    return total;
+}
+
+int write_stream_block(conv_config_t* restrict conv_conf, SNDFILE* restrict file, quantizer_t* restrict quantizer, double* restrict y_block, size_t frames, uint8_t flush_flag)
+{
+    for (size_t i = 0; i < frames * conv_conf->channels; i++) {
+        track_sample(&conv_conf->stats, y_block[i]);
+    }
+
+    /* Audio is scaled as it is converted, text as it is formatted */
+    if (file) {
+        CHECK_RET(write_audio_frames(conv_conf, file, quantizer, y_block, frames));
+        if (flush_flag) {
+            sf_write_sync(file);
+        }
+
+        return 0;
+    }
+
+    write_frames(stdout, conv_conf, y_block, frames);
+    if (flush_flag && fflush(stdout)) {
+        fprintf(stderr, "\nUnable to write y[n] to stdout.\n");
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int select_raw_dtype(conv_config_t* restrict conv_conf, char* restrict strval)
+{
+    if (!(strcmp("s16", strval))) {
+        conv_conf->raw_format = SF_FORMAT_PCM_16;
+    } else if (!(strcmp("s24", strval))) {
+        conv_conf->raw_format = SF_FORMAT_PCM_24;
+    } else if (!(strcmp("s32", strval))) {
+        conv_conf->raw_format = SF_FORMAT_PCM_32;
+    } else if (!(strcmp("f32", strval))) {
+        conv_conf->raw_format = SF_FORMAT_FLOAT;
+    } else if (!(strcmp("f64", strval))) {
+        conv_conf->raw_format = SF_FORMAT_DOUBLE;
+    } else {
+        fprintf(stderr, "\nRaw sample type '%s' not supported. Select between: 's16', 's24', 's32', 'f32', and 'f64'.\n", strval);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int select_out_subtype(conv_config_t* restrict conv_conf, char* restrict strval)
+{
+    if (!(strcmp("pcm16", strval))) {
+        conv_conf->out_subtype = SF_FORMAT_PCM_16;
+    } else if (!(strcmp("pcm24", strval))) {
+        conv_conf->out_subtype = SF_FORMAT_PCM_24;
+    } else if (!(strcmp("pcm32", strval))) {
+        conv_conf->out_subtype = SF_FORMAT_PCM_32;
+    } else if (!(strcmp("float", strval))) {
+        conv_conf->out_subtype = SF_FORMAT_FLOAT;
+    } else if (!(strcmp("double", strval))) {
+        conv_conf->out_subtype = SF_FORMAT_DOUBLE;
+    } else {
+        fprintf(stderr, "\nOutput subtype '%s' not supported. Select between: 'pcm16', 'pcm24', 'pcm32', 'float', and 'double'.\n", strval);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int select_out_container(conv_config_t* restrict conv_conf, char* restrict strval)
+{
+    SF_FORMAT_INFO format_info;
+    int count = 0;
+
+    /* Containers are named by their file extension, the first major format using it is picked */
+    sf_command(NULL, SFC_GET_FORMAT_MAJOR_COUNT, &count, sizeof(int));
+    for (int k = 0; k < count; k++) {
+        format_info.format = k;
+        sf_command(NULL, SFC_GET_FORMAT_MAJOR, &format_info, sizeof(format_info));
+        if (!(strcmp(format_info.extension, strval))) {
+            conv_conf->out_container = format_info.format;
+            conv_conf->out_extension = format_info.extension;
+
+            return 0;
+        }
+    }
+
+    fprintf(stderr, "\nOutput container '%s' not supported. Use the extension of a libsndfile format such as 'wav', 'w64', 'rf64', 'aiff', 'caf', or 'flac'.\n", strval);
+
+    return 1;
+}
+
+int check_out_container(conv_config_t* restrict conv_conf, input_info_t* restrict info_x, input_info_t* restrict info_h)
+{
+    SF_INFO sf_info_y = {0};
+
+    /* The same input write_output takes the format from */
+    if (info_x->input_type == AUDIO_TYPE_CHAR) {
+        sf_info_y = info_x->probe_info;
+    } else if (info_h->input_type == AUDIO_TYPE_CHAR) {
+        sf_info_y = info_h->probe_info;
+    } else {
+        return 0;
+    }
+
+    return set_output_format(conv_conf, &sf_info_y);
+}
+
+int set_output_format(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_y)
+{
+    if (!conv_conf->out_subtype && !conv_conf->out_container) {
+        return 0;
+    }
+
+    if (conv_conf->out_container) {
+        sf_info_y->format = (sf_info_y->format & ~SF_FORMAT_TYPEMASK) | conv_conf->out_container;
+    }
+    if (conv_conf->out_subtype) {
+        sf_info_y->format = (sf_info_y->format & ~SF_FORMAT_SUBMASK) | conv_conf->out_subtype;
+    }
+
+    /* Not every container holds every subtype, FLAC has no floats */
+    if (!sf_format_check(sf_info_y)) {
+        fprintf(stderr, "\nA '%s' output can not hold '%s' samples. Select another '--out-subtype' or '--out-container'.\n", get_sndfile_major_format(sf_info_y), get_sndfile_subtype(sf_info_y));
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int conv_out_of_core(conv_config_t* restrict conv_conf)
+{
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    SF_INFO sf_info_x = {0};
+    SF_INFO sf_info_h = {0};
+    out_of_core_t ooc = {0};
+    char spill_file[MAX_STR + sizeof(SPILL_EXT)];
+    char norm_file[MAX_STR + sizeof(NORM_SPILL_EXT)];
+    int ret = 1;
+
+    conv_conf->total_samples = info_x->data_samples + info_h->data_samples - 1;
+    conv_conf->channels = info_x->channels > info_h->channels ? info_x->channels : info_h->channels;
+
+    const size_t N = get_chunk_sizes(conv_conf, &ooc.chunk_x, &ooc.chunk_h);
+    if (!N) {
+        fprintf(stderr, "\nThe memory limit is too small for a %d point chunk transform.\n", OOC_MIN_FFT_SIZE);
+
+        return 1;
+    }
+
+    CHECK_RET(open_input_file(info_x, &ooc.file_x, &sf_info_x));
+    if (open_input_file(info_h, &ooc.file_h, &sf_info_h) || (conv_conf->norm_bound_flag && set_norm_bound(conv_conf, ooc.file_x, NULL, ooc.file_h, NULL))) {
+        sf_close(ooc.file_x);
+        sf_close(ooc.file_h);
+
+        return 1;
+    }
+
+    SF_INFO sf_info_y = sf_info_x;
+    sf_info_y.channels = conv_conf->channels;
+    if (set_output_format(conv_conf, &sf_info_y)) {
+        sf_close(ooc.file_x);
+        sf_close(ooc.file_h);
+
+        return 1;
+    }
+
+    /* Keep the spill files next to the output, temporary directories are often in memory */
+    generate_file_name(conv_conf->ofile, conv_conf->input_info, conv_conf->input_flag, conv_conf->out_extension);
+    snprintf(spill_file, sizeof(spill_file), "%s%s", conv_conf->ofile, SPILL_EXT);
+    snprintf(norm_file, sizeof(norm_file), "%s%s", conv_conf->ofile, NORM_SPILL_EXT);
+
+    /* Frames still being added to all lie within one x[n] chunk and h[n] of the start of the current x[n] chunk */
+    ooc.spill_window = ooc.chunk_x + info_h->data_samples < conv_conf->total_samples ? ooc.chunk_x + info_h->data_samples : conv_conf->total_samples;
+
+    /* Normalising keeps the completed frames until the peak is known, as floats unless the output has more precision */
+    if (conv_conf->norm_flag) {
+        const int subtype = sf_info_y.format & SF_FORMAT_SUBMASK;
+
+        ooc.norm_bytes = subtype == SF_FORMAT_DOUBLE || subtype == SF_FORMAT_PCM_32 ? sizeof(double) : sizeof(float);
+        ooc.norm_spill = fopen(norm_file, "w+b");
+    }
+
+    ooc.spill = fopen(spill_file, "w+b");
+    ooc.file_y = sf_open(conv_conf->ofile, SFM_WRITE, &sf_info_y);
+    ooc.quantizer = create_quantizer(sf_info_y.format & SF_FORMAT_SUBMASK, 0);
+    ooc.plan = create_fft_plan(N);
+    ooc.x = malloc(ooc.chunk_x * info_x->channels * sizeof(double));
+    ooc.h = malloc(ooc.chunk_h * info_h->channels * sizeof(double));
+    ooc.y = malloc(N * conv_conf->channels * sizeof(double));
+    ooc.acc = malloc(N * conv_conf->channels * sizeof(double));
+    ooc.Y = malloc(N * sizeof(double complex));
+    if (!ooc.spill || (conv_conf->norm_flag && !ooc.norm_spill) || !ooc.file_y || !ooc.quantizer || !ooc.plan || !ooc.x || !ooc.h || !ooc.y || !ooc.acc || !ooc.Y) {
+        fprintf(stderr, "\nUnable to set up the out-of-core engine with output '%s' and spill file '%s'.\n", conv_conf->ofile, spill_file);
+    } else {
+        if (!conv_conf->quiet_flag) {
+            printf("Convolving in chunks of %zu x[n] and %zu h[n] frames with a %zu point FFT.\n", ooc.chunk_x, ooc.chunk_h, N);
+        }
+
+        ret = spill_chunk_products(conv_conf, &ooc);
+        if (!ret && ooc.norm_spill) {
+            ret = write_norm_spill(conv_conf, &ooc);
+        }
+        if (!ret) {
+            if (!conv_conf->quiet_flag) {
+                show_output_level(conv_conf, stdout);
+            }
+            report_clipping(ooc.quantizer);
+            printf("Saved result to '%s'.\n", conv_conf->ofile);
+        }
+    }
+
+    if (ooc.spill) {
+        fclose(ooc.spill);
+        remove(spill_file);
+    }
+    if (ooc.norm_spill) {
+        fclose(ooc.norm_spill);
+        remove(norm_file);
+    }
+    sf_close(ooc.file_y);
+    destroy_quantizer(ooc.quantizer);
+    sf_close(ooc.file_x);
+    sf_close(ooc.file_h);
+    destroy_fft_plan(ooc.plan);
+    free(ooc.x);
+    free(ooc.h);
+    free(ooc.y);
+    free(ooc.acc);
+    free(ooc.Y);
+    return ret;
+}
+
+size_t get_chunk_sizes(conv_config_t* restrict conv_conf, size_t* restrict chunk_x, size_t* restrict chunk_h)
+{
+    const size_t size_x = conv_conf->input_info[X_INDEX].data_samples;
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+    const size_t size_y = conv_conf->total_samples;
+    const size_t pairs = (conv_conf->channels + 1) / 2;
+
+    /* Plan, product spectrum, both sets of spectra, the product and spill buffers, and both input chunks */
+    const size_t point_bytes = sizeof(double complex) / 2 + sizeof(size_t) + sizeof(double complex) * (1 + 2 * pairs) + 2 * sizeof(double) * conv_conf->channels +
+        sizeof(double) * (conv_conf->input_info[X_INDEX].channels + conv_conf->input_info[H_INDEX].channels);
+
+    size_t N = OOC_MIN_FFT_SIZE;
+    if (N * point_bytes > conv_conf->mem_limit) {
+        return 0;
+    }
+    while (N < nextpow2(size_y) && 2 * N * point_bytes <= conv_conf->mem_limit) {
+        N *= 2;
+    }
+
+    /* Everything fits in one transform */
+    if (size_y <= N) {
+        *chunk_x = size_x;
+        *chunk_h = size_h;
+
+        return N;
+    }
+
+    /* Otherwise a chunk pair fills the transform, with the longer share going to x[n] if h[n] is short */
+    *chunk_h = size_h < N / 2 ? size_h : N / 2;
+    *chunk_x = N - *chunk_h + 1 < size_x ? N - *chunk_h + 1 : size_x;
+
+    return N;
+}
+
+int spill_chunk_products(conv_config_t* restrict conv_conf, out_of_core_t* restrict ooc)
+{
+    const size_t size_x = conv_conf->input_info[X_INDEX].data_samples;
+    const size_t size_h = conv_conf->input_info[H_INDEX].data_samples;
+    const uint8_t channels_x = conv_conf->input_info[X_INDEX].channels;
+    const uint8_t channels_h = conv_conf->input_info[H_INDEX].channels;
+    const uint8_t channels = conv_conf->channels;
+    const size_t N = ooc->plan->N;
+    spectra_t H = {0};
+    int ret = 0;
+
+    /* A single h[n] chunk is transformed once for every x[n] chunk */
+    if (ooc->chunk_h == size_h) {
+        if ((size_t)sf_readf_double(ooc->file_h, ooc->h, size_h) != size_h || transform_channels(ooc->plan, double_samples(ooc->h), size_h, channels_h, channels, &H)) {
+            fprintf(stderr, "\nUnable to read and transform h[n].\n");
+            free_spectra(&H);
+
+            return 1;
+        }
+    }
+
+    for (size_t start_x = 0; start_x < size_x && !ret; start_x += ooc->chunk_x) {
+        const size_t frames_x = size_x - start_x < ooc->chunk_x ? size_x - start_x : ooc->chunk_x;
+        spectra_t X = {0};
+
+        if ((size_t)sf_readf_double(ooc->file_x, ooc->x, frames_x) != frames_x || transform_channels(ooc->plan, double_samples(ooc->x), frames_x, channels_x, channels, &X)) {
+            fprintf(stderr, "\nUnable to read and transform x[n] at frame %zu.\n", start_x);
+            free_spectra(&X);
+            ret = 1;
+
+            break;
+        }
+
+        for (size_t start_h = 0; start_h < size_h; start_h += ooc->chunk_h) {
+            const size_t frames_h = size_h - start_h < ooc->chunk_h ? size_h - start_h : ooc->chunk_h;
+            const size_t frames_y = frames_x + frames_h - 1;
+
+            if (ooc->chunk_h != size_h) {
+                free_spectra(&H);
+                if (sf_seek(ooc->file_h, start_h, SEEK_SET) < 0 || (size_t)sf_readf_double(ooc->file_h, ooc->h, frames_h) != frames_h ||
+                        transform_channels(ooc->plan, double_samples(ooc->h), frames_h, channels_h, channels, &H)) {
+                    fprintf(stderr, "\nUnable to read and transform h[n] at frame %zu.\n", start_h);
+                    ret = 1;
+
+                    break;
+                }
+            }
+
+            for (uint8_t p = 0; p < X.pairs; p++) {
+                const uint8_t c = 2 * p;
+
+                memset(ooc->Y, 0, N * sizeof(double complex));
+                multiply_spectra(ooc->Y, X.bins[p], X.shared[p], H.bins[p], H.shared[p], N);
+                fft(ooc->plan, ooc->Y, 1);
+                unpack_channel_pair(ooc->Y, N, ooc->y, frames_y, channels, c, c + 1 < channels ? c + 1 : NO_CHANNEL, NULL);
+            }
+
+            /* Frames before the next chunk pair of either input are complete */
+            size_t final = conv_conf->total_samples;
+            if (start_h + ooc->chunk_h < size_h && start_x + start_h + ooc->chunk_h < final) {
+                final = start_x + start_h + ooc->chunk_h;
+            }
+            if (start_x + ooc->chunk_x < size_x && start_x + ooc->chunk_x < final) {
+                final = start_x + ooc->chunk_x;
+            }
+
+            if (accumulate_spill(conv_conf, ooc, start_x + start_h, frames_y, final)) {
+                ret = 1;
+
+                break;
+            }
+        }
+
+        free_spectra(&X);
+    }
+
+    free_spectra(&H);
+    return ret;
+}
+
+int accumulate_spill(conv_config_t* restrict conv_conf, out_of_core_t* restrict ooc, size_t start, size_t frames, size_t final)
+{
+    const uint8_t channels = conv_conf->channels;
+    size_t existing = 0;
+
+    /* Frames past the ones added to so far have no partial sums yet */
+    if (start < ooc->spill_frames) {
+        existing = ooc->spill_frames - start < frames ? ooc->spill_frames - start : frames;
+    }
+
+    if (existing && transfer_spill(ooc, start, existing, channels, ooc->acc, 0)) {
+        fprintf(stderr, "\nUnable to read the spill file.\n");
+
+        return 1;
+    }
+    memset(ooc->acc + existing * channels, 0, (frames - existing) * channels * sizeof(double));
+
+    for (size_t i = 0; i < frames * channels; i++) {
+        ooc->acc[i] += ooc->y[i];
+    }
+
+    if (start + frames > ooc->spill_frames) {
+        ooc->spill_frames = start + frames;
+    }
+
+    /* Only the frames still being added to go back to the spill file */
+    const size_t first = final > start ? final : start;
+    if (first < start + frames && transfer_spill(ooc, first, start + frames - first, channels, ooc->acc + (first - start) * channels, 1)) {
+        fprintf(stderr, "\nUnable to write the spill file.\n");
+
+        return 1;
+    }
+
+    /* The frames that just became complete are all in this chunk pair, and come in order */
+    if (final > ooc->final_frames) {
+        const size_t done = ooc->final_frames > start ? ooc->final_frames : start;
+
+        CHECK_RET(write_completed_frames(conv_conf, ooc, ooc->acc + (done - start) * channels, final - done));
+        ooc->final_frames = final;
+    }
+
+    return 0;
+}
+
+int transfer_spill(out_of_core_t* restrict ooc, size_t frame, size_t frames, uint8_t channels, double* restrict buf, uint8_t write_flag)
+{
+    while (frames) {
+        const size_t pos = frame % ooc->spill_window;
+        const size_t count = ooc->spill_window - pos < frames ? ooc->spill_window - pos : frames;
+
+        CHECK_RET(seek_spill(ooc->spill, pos, channels));
+        if ((write_flag ? fwrite(buf, channels * sizeof(double), count, ooc->spill) : fread(buf, channels * sizeof(double), count, ooc->spill)) != count) {
+            return 1;
+        }
+
+        frame += count;
+        frames -= count;
+        buf += count * channels;
+    }
+
+    return 0;
+}
+
+int write_completed_frames(conv_config_t* restrict conv_conf, out_of_core_t* restrict ooc, double* restrict y, size_t frames)
+{
+    const size_t size = frames * conv_conf->channels;
+
+    for (size_t i = 0; i < size; i++) {
+        track_sample(&conv_conf->stats, y[i]);
+    }
+
+    /* First pass of normalising, the frames wait in the normalisation spill file. The product buffer is free again by now */
+    if (ooc->norm_spill) {
+        if (ooc->norm_bytes == sizeof(float)) {
+            float* buf = (float*)ooc->y;
+            for (size_t i = 0; i < size; i++) {
+                buf[i] = (float)y[i];
+            }
+        } else {
+            memcpy(ooc->y, y, size * sizeof(double));
+        }
+
+        if (fwrite(ooc->y, ooc->norm_bytes, size, ooc->norm_spill) != size) {
+            fprintf(stderr, "\nUnable to write the normalisation spill file.\n");
+
+            return 1;
+        }
+
+        return 0;
+    }
+
+    return write_audio_frames(conv_conf, ooc->file_y, ooc->quantizer, y, frames);
+}
+
+int seek_spill(FILE* restrict spill, size_t frame, uint8_t channels)
+{
+#ifdef _WIN32
+    return _fseeki64(spill, (long long)(frame * channels * sizeof(double)), SEEK_SET);
+#else
+    return fseeko(spill, (off_t)(frame * channels * sizeof(double)), SEEK_SET);
+#endif
+}
+
+int write_norm_spill(conv_config_t* restrict conv_conf, out_of_core_t* restrict ooc)
+{
+    const uint8_t channels = conv_conf->channels;
+    const size_t size_y = conv_conf->total_samples;
+    const size_t chunk = ooc->plan->N;
+
+    /* Read the stored samples into the product buffer and widen them into the spill buffer */
+    conv_conf->scale = get_output_scale(conv_conf);
+    rewind(ooc->norm_spill);
+    for (size_t start = 0; start < size_y; start += chunk) {
+        const size_t frames = size_y - start < chunk ? size_y - start : chunk;
+
+        if (fread(ooc->y, ooc->norm_bytes * channels, frames, ooc->norm_spill) != frames) {
+            fprintf(stderr, "\nUnable to read the normalisation spill file.\n");
+
+            return 1;
+        }
+        for (size_t i = 0; i < frames * channels; i++) {
+            ooc->acc[i] = ooc->norm_bytes == sizeof(float) ? ((float*)ooc->y)[i] : ooc->y[i];
+        }
+
+        CHECK_RET(write_audio_frames(conv_conf, ooc->file_y, ooc->quantizer, ooc->acc, frames));
+    }
+
+    return 0;
+}
+
+int map_file(char* restrict path, mapped_file_t* restrict map)
+{
+    memset(map, 0, sizeof(mapped_file_t));
+
+#ifdef _WIN32
+    LARGE_INTEGER size;
+
+    map->file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+    if (map->file == INVALID_HANDLE_VALUE) {
+        return 1;
+    }
+
+    if (!GetFileSizeEx(map->file, &size) || size.QuadPart == 0) {
+        CloseHandle(map->file);
+
+        return 1;
+    }
+
+    map->mapping = CreateFileMappingA(map->file, NULL, PAGE_READONLY, 0, 0, NULL);
+    if (!map->mapping) {
+        CloseHandle(map->file);
+
+        return 1;
+    }
+
+    map->data = MapViewOfFile(map->mapping, FILE_MAP_READ, 0, 0, 0);
+    if (!map->data) {
+        CloseHandle(map->mapping);
+        CloseHandle(map->file);
+
+        return 1;
+    }
+
+    map->size = size.QuadPart;
+#else
+    struct stat file_stat;
+
+    int fd = open(path, O_RDONLY);
+    if (fd < 0) {
+        return 1;
+    }
+
+    if (fstat(fd, &file_stat) || file_stat.st_size == 0) {
+        close(fd);
+
+        return 1;
+    }
+
+    map->data = mmap(NULL, file_stat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (map->data == MAP_FAILED) {
+        map->data = NULL;
+
+        return 1;
+    }
+
+    map->size = file_stat.st_size;
+#endif
+
+    return 0;
+}
+
+void unmap_file(mapped_file_t* map)
+{
+    if (!map->data) {
+        return;
+    }
+
+#ifdef _WIN32
+    UnmapViewOfFile(map->data);
+    CloseHandle(map->mapping);
+    CloseHandle(map->file);
+#else
+    munmap(map->data, map->size);
+#endif
+
+    map->data = NULL;
+    map->size = 0;
+}
+
+int hash_input(input_info_t* restrict input_info, uint64_t* restrict hash)
+{
+    unsigned char buffer[1 << 16];
+    size_t count = 0;
+
+    *hash = FNV_OFFSET_BASIS;
+
+    /* CSV strings have no file to hash */
+    if (input_info->input_type == STR_TYPE_CHAR) {
+        for (char* c = input_info->ibuff; *c != '\0'; c++) {
+            *hash = (*hash ^ (unsigned char)*c) * FNV_PRIME;
+        }
+
+        return 0;
+    }
+
+    FILE* file = fopen(input_info->ibuff, "rb");
+    if (!file) {
+        fprintf(stderr, "\nUnable to open '%s' for hashing.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    while ((count = fread(buffer, 1, sizeof(buffer), file)) > 0) {
+        for (size_t i = 0; i < count; i++) {
+            *hash = (*hash ^ buffer[i]) * FNV_PRIME;
+        }
+    }
+
+    fclose(file);
+    return 0;
+}
+
+int get_ir_cache_file(conv_config_t* restrict conv_conf, char* restrict cache_file, uint64_t* restrict hash)
+{
+    CHECK_RET(hash_input(&conv_conf->input_info[H_INDEX], hash));
+
+    /* The requested block size decides the partitions and the FFT size */
+    snprintf(cache_file, 2 * MAX_STR, "%s/%016llx-%zu%s", conv_conf->cache_dir, (unsigned long long)*hash, conv_conf->block_size, IR_CACHE_EXT);
+
+    return 0;
+}
+
+int load_ir_cache(conv_config_t* restrict conv_conf, char* restrict cache_file, uint64_t hash, SF_INFO* restrict sf_info_h)
+{
+    mapped_file_t map;
+
+    if (map_file(cache_file, &map)) {
+        return 1;
+    }
+
+    /* Check the header against the file before trusting it */
+    ir_cache_header_t* header = map.data;
+    if (map.size < sizeof(ir_cache_header_t) || memcmp(header->magic, IR_CACHE_MAGIC, sizeof(header->magic)) ||
+            header->hash != hash || header->requested_size != conv_conf->block_size || header->channels == 0 ||
+            map.size != sizeof(ir_cache_header_t) + header->partitions * header->channels * (header->block_size + 1) * sizeof(double complex)) {
+        fprintf(stderr, "Ignoring invalid cache file '%s'.\n", cache_file);
+        unmap_file(&map);
+
+        return 1;
+    }
+
+    partitioned_ir_t* ir = calloc(1, sizeof(partitioned_ir_t));
+    if (!ir) {
+        unmap_file(&map);
+
+        return 1;
+    }
+
+    ir->block_size = header->block_size;
+    ir->partitions = header->partitions;
+    ir->channels = header->channels;
+    ir->bins = (double complex*)((char*)map.data + sizeof(ir_cache_header_t));
+    ir->map = map;
+
+    conv_conf->input_info[H_INDEX].data_samples = header->size_h;
+    conv_conf->input_info[H_INDEX].channels = header->channels;
+    sf_info_h->frames = header->size_h;
+    sf_info_h->samplerate = header->samplerate;
+    sf_info_h->format = header->format;
+    sf_info_h->channels = header->channels;
+    conv_conf->ir = ir;
+
+    if (!conv_conf->quiet_flag) {
+        printf("Loaded h[n] spectra from cache '%s'.\n", cache_file);
+    }
+
+    return 0;
+}
+
+int save_ir_cache(conv_config_t* restrict conv_conf, char* restrict cache_file, uint64_t hash, SF_INFO* restrict sf_info_h)
+{
+    partitioned_ir_t* ir = conv_conf->ir;
+    char temp_file[2 * MAX_STR + 32];
+    ir_cache_header_t header;
+
+    memset(&header, 0, sizeof(ir_cache_header_t));
+    memcpy(header.magic, IR_CACHE_MAGIC, sizeof(header.magic));
+    header.hash = hash;
+    header.requested_size = conv_conf->block_size;
+    header.block_size = ir->block_size;
+    header.partitions = ir->partitions;
+    header.size_h = conv_conf->input_info[H_INDEX].data_samples;
+    header.samplerate = sf_info_h->samplerate;
+    header.format = sf_info_h->format;
+    header.channels = ir->channels;
+    header.input_type = conv_conf->input_info[H_INDEX].input_type;
+
+    /* Create the cache directory on first use */
+#ifdef _WIN32
+    CreateDirectoryA(conv_conf->cache_dir, NULL);
+    snprintf(temp_file, sizeof(temp_file), "%s.%lu.tmp", cache_file, GetCurrentProcessId());
+#else
+    mkdir(conv_conf->cache_dir, 0755);
+    snprintf(temp_file, sizeof(temp_file), "%s.%ld.tmp", cache_file, (long)getpid());
+#endif
+
+    FILE* file = fopen(temp_file, "wb");
+    if (!file) {
+        fprintf(stderr, "Unable to write cache file '%s'.\n", temp_file);
+
+        return 1;
+    }
+
+    const size_t bins = ir->partitions * ir->channels * (ir->block_size + 1);
+    if (fwrite(&header, sizeof(ir_cache_header_t), 1, file) != 1 || fwrite(ir->bins, sizeof(double complex), bins, file) != bins) {
+        fprintf(stderr, "Unable to write cache file '%s'.\n", temp_file);
+        fclose(file);
+        remove(temp_file);
+
+        return 1;
+    }
+
+    fclose(file);
+
+    if (rename(temp_file, cache_file)) {
+        remove(temp_file);
+    }
+
+    return 0;
+}
+
+int read_ir_input(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_h, double** restrict h)
+{
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    char cache_file[2 * MAX_STR];
+    uint64_t hash = 0;
+
+    if (conv_conf->cache_dir[0] == '\0') {
+        return info_h->inp(info_h, sf_info_h, h);
+    }
+
+    /* A cache hit skips decoding and transforming h[n] */
+    CHECK_RET(get_ir_cache_file(conv_conf, cache_file, &hash));
+    if (!load_ir_cache(conv_conf, cache_file, hash, sf_info_h)) {
+        return 0;
+    }
+
+    CHECK_RET(info_h->inp(info_h, sf_info_h, h));
+
+    const size_t block_size = get_block_size(conv_conf->block_size, info_h->data_samples);
+    fft_plan_t* plan = create_fft_plan(2 * block_size);
+    if (plan) {
+        conv_conf->ir = partition_ir(plan, get_input_samples(info_h, *h), info_h->data_samples, info_h->channels);
+    }
+    destroy_fft_plan(plan);
+
+    if (!conv_conf->ir) {
+        fprintf(stderr, "\nUnable to partition h[n] into blocks of %zu samples.\n", block_size);
+
+        return 1;
+    }
+
+    /* A failed store only costs the next run a decode */
+    if (!save_ir_cache(conv_conf, cache_file, hash, sf_info_h) && !conv_conf->quiet_flag) {
+        printf("Stored h[n] spectra in cache '%s'.\n", cache_file);
+    }
+
+    return 0;
+}
+
+uint16_t get_cpu_count()
+{
+#ifdef _WIN32
+    SYSTEM_INFO system_info;
+    GetSystemInfo(&system_info);
+
+    return system_info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? count : 1;
+#endif
+}
+
+size_t nextpow2(size_t n)
+{
+    size_t N = 1;
+    while (N < n) {
+        N <<= 1;
+    }
+
+    return N;
+}
+
+size_t index_bit_reversal(size_t index, uint8_t bits)
+{
+    size_t reversed = 0;
+    for (uint8_t b = 0; b < bits; b++) {
+        reversed = (reversed << 1) | ((index >> b) & 1);
+    }
+
+    return reversed;
+}
+
+double complex get_twiddle_factor(size_t k, size_t N)
+{
+    return cexp(-2.0 * I * M_PI * k / N);
+}
+
+double complex complex_mul(double complex a, double complex b)
+{
+    return CMPLX(creal(a) * creal(b) - cimag(a) * cimag(b), creal(a) * cimag(b) + cimag(a) * creal(b));
+}
+
+fft_plan_t* create_fft_plan(size_t N)
+{
+    fft_plan_t* plan = malloc(sizeof(fft_plan_t));
+    if (!plan) {
+        return NULL;
+    }
+
+    plan->N = N;
+    plan->twiddles = malloc((N / 2 + 1) * sizeof(double complex));
+    plan->rev = malloc(N * sizeof(size_t));
+    if (!plan->twiddles || !plan->rev) {
+        destroy_fft_plan(plan);
+
+        return NULL;
+    }
+
+    uint8_t bits = 0;
+    while (((size_t)1 << bits) < N) {
+        bits++;
+    }
+
+    for (size_t k = 0; k < N / 2; k++) {
+        plan->twiddles[k] = get_twiddle_factor(k, N);
+    }
+
+    for (size_t n = 0; n < N; n++) {
+        plan->rev[n] = index_bit_reversal(n, bits);
+    }
+
+    return plan;
+}
+
+void destroy_fft_plan(fft_plan_t* plan)
+{
+    if (!plan) {
+        return;
+    }
+
+    free(plan->twiddles);
+    free(plan->rev);
+    free(plan);
+}
+
+void fft(fft_plan_t* restrict plan, double complex* restrict X, uint8_t inverse)
+{
+    const size_t N = plan->N;
+
+    /* Reorder the data */
+    for (size_t n = 0; n < N; n++) {
+        size_t r = plan->rev[n];
+        if (r > n) {
+            double complex temp = X[n];
+            X[n] = X[r];
+            X[r] = temp;
+        }
+    }
+
+    /* Butterflies */
+    for (size_t len = 2; len <= N; len <<= 1) {
+        const size_t half = len >> 1;
+        const size_t step = N / len;
+
+        for (size_t i = 0; i < N; i += len) {
+            for (size_t k = 0; k < half; k++) {
+                double complex w = plan->twiddles[k * step];
+                if (inverse) {
+                    w = conj(w);
+                }
+                double complex t = complex_mul(w, X[i + k + half]);
+                X[i + k + half] = X[i + k] - t;
+                X[i + k] += t;
+            }
+        }
+    }
+}
+
+void fft_2d(fft_plan_t* restrict row_plan, fft_plan_t* restrict column_plan, double complex* restrict Z, size_t rows, double complex* restrict column, uint8_t inverse)
+{
+    const size_t R = column_plan->N;
+    const size_t C = row_plan->N;
+
+    /* Rows past the given ones are zero going forward and are not needed coming back, so they skip their row FFT */
+    if (!inverse) {
+        for (size_t m = 0; m < rows; m++) {
+            fft(row_plan, Z + m * C, 0);
+        }
+    }
+
+    for (size_t n = 0; n < C; n++) {
+        for (size_t m = 0; m < R; m++) {
+            column[m] = Z[m * C + n];
+        }
+        fft(column_plan, column, inverse);
+        for (size_t m = 0; m < R; m++) {
+            Z[m * C + n] = column[m];
+        }
+    }
+
+    if (inverse) {
+        for (size_t m = 0; m < rows; m++) {
+            fft(row_plan, Z + m * C, 1);
+        }
+    }
+}
+
+void pack_channel_pair(double complex* restrict Z, size_t N, samples_t x, size_t frames, uint8_t channels, uint8_t re, int16_t im)
+{
+    for (size_t n = 0; n < frames; n++) {
+        Z[n] = CMPLX(get_sample(x, n * channels + re), im == NO_CHANNEL ? 0.0 : get_sample(x, n * channels + im));
+    }
+
+    memset(Z + frames, 0, (N - frames) * sizeof(double complex));
+}
+
+void unpack_channel_pair(double complex* restrict Y, size_t N, double* restrict y, size_t frames, uint8_t channels, uint8_t re, int16_t im, output_stats_t* restrict stats)
+{
+    const double scale = 1.0 / N;
+
+    for (size_t n = 0; n < frames; n++) {
+        y[n * channels + re] = creal(Y[n]) * scale;
+        if (im != NO_CHANNEL) {
+            y[n * channels + im] = cimag(Y[n]) * scale;
+        }
+
+        if (stats) {
+            track_sample(stats, y[n * channels + re]);
+            if (im != NO_CHANNEL) {
+                track_sample(stats, y[n * channels + im]);
+            }
+        }
+    }
+}
+
+int transform_channels(fft_plan_t* restrict plan, samples_t x, size_t frames, uint8_t channels, uint8_t out_channels, spectra_t* restrict S)
+{
+    S->N = plan->N;
+    S->pairs = (out_channels + 1) / 2;
+    S->channels = out_channels;
+    S->shared = calloc(S->pairs, sizeof(uint8_t));
+    S->bins = calloc(S->pairs, sizeof(double complex*));
+    if (!S->shared || !S->bins) {
+        fprintf(stderr, "\nUnable to allocate the channel spectra.\n");
+
+        return 1;
+    }
+
+    for (uint8_t p = 0; p < S->pairs; p++) {
+        const uint8_t c = 2 * p;
+        const uint8_t re = c % channels;
+        int16_t im = c + 1 < out_channels ? (c + 1) % channels : NO_CHANNEL;
+
+        /* A single channel feeding both outputs is transformed on its own */
+        if (im == re) {
+            im = NO_CHANNEL;
+        }
+        S->shared[p] = im == NO_CHANNEL;
+
+        S->bins[p] = malloc(S->N * sizeof(double complex));
+        if (!S->bins[p]) {
+            fprintf(stderr, "\nUnable to allocate the channel spectra.\n");
+
+            return 1;
+        }
+
+        pack_channel_pair(S->bins[p], S->N, x, frames, channels, re, im);
+        fft(plan, S->bins[p], 0);
+    }
+
+    return 0;
+}
+
+void free_spectra(spectra_t* S)
+{
+    if (S->bins) {
+        for (uint8_t p = 0; p < S->pairs; p++) {
+            free(S->bins[p]);
+        }
+    }
+
+    free(S->bins);
+    free(S->shared);
+    S->bins = NULL;
+    S->shared = NULL;
+    S->pairs = 0;
+}
+
+void multiply_spectra(double complex* restrict Y, double complex* restrict A, uint8_t a_shared, double complex* restrict B, uint8_t b_shared, size_t N)
+{
+    /* A real channel scales both halves of the other pair alike, so no separation is needed */
+    if (a_shared || b_shared) {
+        for (size_t k = 0; k < N; k++) {
+            Y[k] += complex_mul(A[k], B[k]);
+        }
+
+        return;
+    }
+
+    /* Separate both pairs, A0 = (A[k] + A*[N-k])/2 and A1 = (A[k] - A*[N-k])/2j, then Y = A0B0 + jA1B1 */
+    for (size_t k = 0; k < N; k++) {
+        const size_t kc = (N - k) & (N - 1);
+        const double complex a0 = 0.5 * (A[k] + conj(A[kc]));
+        const double complex a1 = 0.5 * (A[k] - conj(A[kc]));
+        const double complex b0 = 0.5 * (B[k] + conj(B[kc]));
+        const double complex b1 = 0.5 * (B[k] - conj(B[kc]));
+
+        /* jA1B1 = j(a1/j)(b1/j) = -j(a1b1) */
+        const double complex p1 = complex_mul(a1, b1);
+        Y[k] += complex_mul(a0, b0) + CMPLX(cimag(p1), -creal(p1));
+    }
+}
+
+void multiply_packed_inputs(double complex* restrict Z, size_t N)
+{
+    /* X[k]H[k] = (Z[k]^2 - Z*[N-k]^2)/4j, computed for k and N-k together */
+    for (size_t k = 0; k <= N / 2; k++) {
+        multiply_packed_pair(Z, k, (N - k) & (N - 1));
+    }
+}
+
+void multiply_packed_inputs_2d(double complex* restrict Z, size_t rows, size_t columns)
+{
+    /* The conjugate bin is mirrored in both dimensions, rows that are their own mirror hold both bins of a pair */
+    for (size_t k1 = 0; k1 <= rows / 2; k1++) {
+        const size_t kc1 = (rows - k1) & (rows - 1);
+        const size_t last = k1 == kc1 ? columns / 2 : columns - 1;
+
+        for (size_t k2 = 0; k2 <= last; k2++) {
+            multiply_packed_pair(Z, k1 * columns + k2, kc1 * columns + ((columns - k2) & (columns - 1)));
+        }
+    }
+}
+
+char* get_datetime_string()
+{
+    time_t time_since_epoch = time(NULL);
+    struct tm* tm = localtime(&time_since_epoch);
+    static char s[13];
+    strftime(s, sizeof(s), "%d%m%y%H%M%S", tm);
+
+    return s;
+}
+
+char* get_extension(char* restrict ifile_name)
+{
+    uint8_t extension_len = 0;
+    uint8_t dot_index = 0;
+    static char* extension = NULL;
+
+    /* Remove the path specifier */
+    if (ifile_name[0] == '.' && ifile_name[1] == '\\') {
+        memmove(ifile_name, ifile_name + 2, MAX_STR - 2);
+    }
+
+    const uint16_t ifile_name_length = strlen(ifile_name);
+
+    for (uint16_t i = ifile_name_length; i > 0; i--) {
+        if (ifile_name[i] != '\0') {
+            extension_len++;
+            if (ifile_name[i] == '.') {
+                dot_index = i;
+                break;
+            }
+        }
+    }
+
+    extension = calloc(sizeof(char), extension_len);
+    for (uint16_t i = dot_index; i < ifile_name_length; i++) {
+        if (ifile_name[i] != '\0') {
+            extension[i - dot_index] = ifile_name[i];
+        }
+    }
+
+    if (strlen(extension) < 1) {
+        free(extension);
+
+        return "\0";
+    }
+
+    return extension;
+}
+
+char* get_base_name(char* restrict ifile_name)
+{
+    char* base_name = ifile_name;
+
+    for (char* c = ifile_name; *c != '\0'; c++) {
+        if (*c == '/' || *c == '\\') {
+            base_name = c + 1;
+        }
+    }
+
+    return base_name;
+}
+
+void generate_file_name(char* restrict ofile, input_info_t* restrict input_info, uint8_t input_flag, const char* restrict extension)
+{
+    if (ofile[0] != '\0' ) {
+
+        return;
+    }
+
+    char* ifile_no_extension_x = calloc(sizeof(char), MIN_STR);
+    char* ifile_no_extension_h = calloc(sizeof(char), MIN_STR);
+    char* extension_x = calloc(sizeof(char), MAX_EXT_STR);
+    char* extension_h = calloc(sizeof(char), MAX_EXT_STR);
+    char* base_name = NULL;
+
+    switch (input_info[X_INDEX].input_type) {
+        case AUDIO_TYPE_CHAR:
+        case CSV_TYPE_CHAR:
+        case RAW_TYPE_CHAR:
+        case NPY_TYPE_CHAR:
+            extension_x = get_extension(input_info[X_INDEX].ibuff);
+            base_name = get_base_name(input_info[X_INDEX].ibuff);
+            strncpy(ifile_no_extension_x, base_name, strlen(base_name) - strlen(extension_x) < MIN_STR ? strlen(base_name) - strlen(extension_x) : MIN_STR - 1);
+            break;
+        case STR_TYPE_CHAR:
+            strcpy(ifile_no_extension_x, "stringcsv");
+            break;
+        default:
+            fprintf(stderr, "Type char not supported.\n");
+            return;
+    }
+
+    switch (input_info[H_INDEX].input_type) {
+        case AUDIO_TYPE_CHAR:
+        case CSV_TYPE_CHAR:
+        case RAW_TYPE_CHAR:
+        case NPY_TYPE_CHAR:
+            extension_h = get_extension(input_info[H_INDEX].ibuff);
+            base_name = get_base_name(input_info[H_INDEX].ibuff);
+            strncpy(ifile_no_extension_h, base_name, strlen(base_name) - strlen(extension_h) < MIN_STR ? strlen(base_name) - strlen(extension_h) : MIN_STR - 1);
+            break;
+        case STR_TYPE_CHAR:
+            strcpy(ifile_no_extension_h, "stringcsv");
+            break;
+        default:
+            fprintf(stderr, "Type char not supported.\n");
+            return;
+    }
+
+    /* Use the h[n] input to decide the output extension, unless the output container is set */
+    if (extension) {
+        sprintf(ofile, "conv-%s-%s-%s.%s", ifile_no_extension_x, ifile_no_extension_h, get_datetime_string(), extension);
+    } else {
+        sprintf(ofile, "conv-%s-%s-%s%s", ifile_no_extension_x, ifile_no_extension_h, get_datetime_string(), extension_h);
+    }
+}
+
+int select_output_format(conv_config_t* restrict conv_conf, char* restrict strval)
+{
+    conv_conf->outp = NULL;
+
+    if(!(strcmp("audio", strval))) {
+        conv_conf->outp = &output_file_audio; 
+    }
+    if(!(strcmp("stdout", strval))) {
+        conv_conf->outp = &output_stdout; 
+    }
+    if(!(strcmp("stdout-csv", strval))) {
+        conv_conf->outp = &output_stdout_csv; 
+    }
+    if(!(strcmp("columns", strval))) {
+        conv_conf->outp = &output_file_columns; 
+    }
+    if(!(strcmp("csv", strval))) {
+        conv_conf->outp = &output_file_csv; 
+    }
+    if(!(strcmp("raw-f64", strval))) {
+        conv_conf->outp = &output_file_raw_f64;
+    }
+    if(!(strcmp("raw-f32", strval))) {
+        conv_conf->outp = &output_file_raw_f32;
+    }
+    if(!(strcmp("npy", strval))) {
+        conv_conf->outp = &output_file_npy;
+    }
+
+    if (!conv_conf->outp){
+        fprintf(stderr, "\nOutput format '%s' not available.\n", strval);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int read_audio_file_input(input_info_t* restrict input_data, SF_INFO* restrict sf_info, double** restrict x)
+{
+    SNDFILE* file = NULL;          // Pointer to the input audio file
+
+    /* Plain WAV files are read in place */
+    if (!map_wav_input(input_data, sf_info)) {
+        close_probe(input_data);
+        *x = NULL;
+
+        return 0;
+    }
+
+    /* Decode from the probe handle if it is still open */
+    CHECK_RET(open_input_file(input_data, &file, sf_info));
+
+    /* 16-bit PCM is kept as it is, a quarter of the size of doubles */
+    if ((sf_info->format & SF_FORMAT_SUBMASK) == SF_FORMAT_PCM_16) {
+        *x = NULL;
+        if (get_audio_file_shorts(file, sf_info, input_data)) {
+            sf_close(file);
+
+            return 1;
+        }
+    } else if (get_audio_file_data(file, sf_info, x)) {
+        sf_close(file);
+
+        return 1;
+    }
+
+    input_data->data_samples = sf_info->frames;
+    input_data->channels = sf_info->channels;
+
+    sf_close(file);
+    return 0;
+}
+
+int map_wav_input(input_info_t* restrict input_info, SF_INFO* restrict sf_info)
+{
+    const uint16_t byte_order = 1;
+    SF_INFO sf_info_wav = {0};
+    size_t data_offset = 0;
+
+    /* The samples are used as they are, so they have to be in host byte order */
+    if (*(const uint8_t*)&byte_order != 1) {
+        return 1;
+    }
+
+    /* The probe already knows if the file is a WAV worth mapping */
+    const int probe_format = input_info->probe_info.format;
+    if (probe_format && ((probe_format & SF_FORMAT_TYPEMASK) != SF_FORMAT_WAV || !get_sample_bytes(probe_format & SF_FORMAT_SUBMASK) ||
+                (probe_format & SF_FORMAT_SUBMASK) == SF_FORMAT_PCM_24)) {
+        return 1;
+    }
+
+    if (map_file(input_info->ibuff, &input_info->map)) {
+        return 1;
+    }
+
+    if (parse_wav_header(input_info->map.data, input_info->map.size, &sf_info_wav, &data_offset)) {
+        unmap_file(&input_info->map);
+
+        return 1;
+    }
+
+    *sf_info = sf_info_wav;
+    input_info->samples.data = (const char*)input_info->map.data + data_offset;
+    input_info->samples.format = sf_info->format & SF_FORMAT_SUBMASK;
+    input_info->data_samples = sf_info->frames;
+    input_info->channels = sf_info->channels;
+
+    return 0;
+}
+
+int parse_wav_header(const unsigned char* restrict data, size_t size, SF_INFO* restrict sf_info, size_t* restrict data_offset)
+{
+    uint16_t tag = 0;
+    uint16_t channels = 0;
+    uint16_t bits = 0;
+    uint32_t samplerate = 0;
+    int subtype = 0;
+    size_t pos = 12;
+
+    if (size < 12 || memcmp(data, "RIFF", 4) || memcmp(data + 8, "WAVE", 4)) {
+        return 1;
+    }
+
+    while (pos + 8 <= size) {
+        const unsigned char* chunk = data + pos;
+        const size_t chunk_size = chunk[4] | chunk[5] << 8 | chunk[6] << 16 | (uint32_t)chunk[7] << 24;
+
+        if (!memcmp(chunk, "fmt ", 4) && chunk_size >= 16 && pos + 24 <= size) {
+            tag = chunk[8] | chunk[9] << 8;
+            channels = chunk[10] | chunk[11] << 8;
+            samplerate = chunk[12] | chunk[13] << 8 | chunk[14] << 16 | (uint32_t)chunk[15] << 24;
+            bits = chunk[22] | chunk[23] << 8;
+
+            /* WAVE_FORMAT_EXTENSIBLE keeps the real tag at the start of the sub-format GUID */
+            if (tag == 0xFFFE && chunk_size >= 40 && pos + 34 <= size) {
+                tag = chunk[32] | chunk[33] << 8;
+            }
+        } else if (!memcmp(chunk, "data", 4)) {
+            break;
+        }
+
+        pos += 8 + chunk_size + (chunk_size & 1);
+    }
+
+    if (pos + 8 > size || channels == 0 || channels > UINT8_MAX) {
+        return 1;
+    }
+
+    if (tag == 1 && bits == 16) {
+        subtype = SF_FORMAT_PCM_16;
+    } else if (tag == 1 && bits == 32) {
+        subtype = SF_FORMAT_PCM_32;
+    } else if (tag == 3 && bits == 32) {
+        subtype = SF_FORMAT_FLOAT;
+    } else if (tag == 3 && bits == 64) {
+        subtype = SF_FORMAT_DOUBLE;
+    } else {
+        return 1;
+    }
+
+    /* Streamed and truncated files can claim more data than the file holds */
+    const unsigned char* chunk = data + pos;
+    size_t data_bytes = chunk[4] | chunk[5] << 8 | chunk[6] << 16 | (uint32_t)chunk[7] << 24;
+    if (data_bytes > size - pos - 8) {
+        data_bytes = size - pos - 8;
+    }
+
+    memset(sf_info, 0, sizeof(SF_INFO));
+    sf_info->frames = data_bytes / (channels * get_sample_bytes(subtype));
+    sf_info->samplerate = samplerate;
+    sf_info->channels = channels;
+    sf_info->format = SF_FORMAT_WAV | subtype;
+    sf_info->sections = 1;
+    sf_info->seekable = 1;
+    *data_offset = pos + 8;
+
+    return 0;
+}
+
+void release_input(input_info_t* restrict input_info, double* restrict x)
+{
+    free(x);
+    unmap_file(&input_info->map);
+    free(input_info->pcm16);
+    input_info->pcm16 = NULL;
+    input_info->samples.data = NULL;
+    close_probe(input_info);
+}
+
+void close_probe(input_info_t* restrict input_info)
+{
+    if (input_info->probe_file) {
+        sf_close(input_info->probe_file);
+        input_info->probe_file = NULL;
+    }
+    free(input_info->probe_data);
+    input_info->probe_data = NULL;
+}
+
+int open_input_file(input_info_t* restrict input_info, SNDFILE** restrict file, SF_INFO* restrict sf_info)
+{
+    if (input_info->probe_file) {
+        *file = input_info->probe_file;
+        *sf_info = input_info->probe_info;
+        input_info->probe_file = NULL;
+
+        return 0;
+    }
+
+    return open_audio_file(file, sf_info, input_info->ibuff);
+}
+
+int open_audio_file(SNDFILE** restrict file, SF_INFO* restrict sf_info, char* restrict ibuff)
+{
+    *file = sf_open(ibuff, SFM_READ, sf_info);
+    if(!(*file)) {
+        fprintf(stderr, "%s\n", sf_strerror(*file));
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int get_audio_file_data(SNDFILE* restrict file, SF_INFO* restrict sf_info, double** restrict x)
+{
+    /* Get audio file data size */
+    *x = calloc(sf_info->frames * sf_info->channels, sizeof(double));
+
+    /* Read data and place into buffer */
+    sf_count_t sf_count = sf_readf_double(file, *x, sf_info->frames);
+
+    /* Check */
+    if (sf_count != sf_info->frames) {
+        fprintf(stderr, "\nRead count not equal to requested frames, %lld != %lld.\n", sf_count, sf_info->frames);
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int get_audio_file_shorts(SNDFILE* restrict file, SF_INFO* restrict sf_info, input_info_t* restrict input_info)
+{
+    input_info->pcm16 = malloc(sf_info->frames * sf_info->channels * sizeof(int16_t));
+    if (!input_info->pcm16) {
+        fprintf(stderr, "\nUnable to allocate the samples of '%s'.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    sf_count_t sf_count = sf_readf_short(file, input_info->pcm16, sf_info->frames);
+    if (sf_count != sf_info->frames) {
+        fprintf(stderr, "\nRead count not equal to requested frames, %lld != %lld.\n", (long long)sf_count, (long long)sf_info->frames);
+
+        return 1;
+    }
+
+    input_info->samples.data = input_info->pcm16;
+    input_info->samples.format = SF_FORMAT_PCM_16;
+
+    return 0;
+}
+
+void show_input_info(input_info_t* restrict input_info, SF_INFO* restrict sf_info)
+{
+        if (input_info->input_type == 'a') {
+            fprintf(stdout, "File Name: %s\n", input_info->ibuff);
+            fprintf(stdout, "Sample Rate: %d\n", sf_info->samplerate);
+            fprintf(stdout, "Samples: %lld\n", sf_info->frames);
+            fprintf(stdout, "Channels: %d\n", sf_info->channels);
+            fprintf(stdout, "Format: %s\n", get_sndfile_major_format(sf_info));
+            fprintf(stdout, "Subtype: %s\n", get_sndfile_subtype(sf_info));
+        } else if (input_info->input_type == RAW_TYPE_CHAR || input_info->input_type == NPY_TYPE_CHAR) {
+            fprintf(stdout, "File Name: %s\n", input_info->ibuff);
+            fprintf(stdout, "Samples: %zu\n", input_info->data_samples);
+            fprintf(stdout, "Channels: %d\n", input_info->channels);
+            fprintf(stdout, input_info->input_type == RAW_TYPE_CHAR ? "Format: Raw File\n" : "Format: NumPy File\n");
+        } else {
+            fprintf(stdout, input_info->input_type == 'c' ? "File Name: %s\n" : "Input String: %s\n", input_info->ibuff);
+            fprintf(stdout, "Samples: %lld\n", input_info->data_samples);
+            if (input_info->rows) {
+                fprintf(stdout, "Matrix: %zu x %zu\n", input_info->rows, get_matrix_columns(input_info));
+            }
+            fprintf(stdout, input_info->input_type == 'c' ? "Format: CSV File\n" : "Format: CSV String\n");
+        }
+
+}
+
+const char* get_sndfile_major_format(SF_INFO* restrict sf_info)
+{
+    SF_FORMAT_INFO format_info ;
+    int k, count;
+    const uint32_t format_mask = 0x00FF0000;
+    const uint32_t major_format = sf_info->format & format_mask;
+
+    sf_command(NULL, SFC_GET_FORMAT_MAJOR_COUNT, &count, sizeof (int));
+
+    for (k = 0 ; k < count ; k++) {
+        format_info.format = k;
+        sf_command(NULL, SFC_GET_FORMAT_MAJOR, &format_info, sizeof(format_info));
+        if (major_format == format_info.format) {
+            return format_info.name;
+        }
+    }
+
+    return "N/A";
+}
+
+const char* get_sndfile_subtype(SF_INFO* restrict sf_info)
+{
+    SF_FORMAT_INFO format_info ;
+    int k, count;
+    const uint16_t subtype_mask = 0x00FF;
+    const uint16_t subtype = sf_info->format & subtype_mask;
+
+    sf_command(NULL, SFC_GET_FORMAT_SUBTYPE_COUNT, &count, sizeof (int));
+
+    for (k = 0 ; k < count ; k++) {
+        format_info.format = k;
+        sf_command(NULL, SFC_GET_FORMAT_SUBTYPE, &format_info, sizeof(format_info));
+        if (subtype == format_info.format) {
+            return format_info.name;
+        }
+    }
+
+    return "N/A";
+}
+
+int probe_csv_string(input_info_t* restrict input_info)
+{
+    struct timespec start;
+    double* values = NULL;
+    size_t samples = 0;
+
+    /* The string is parsed once here, and the reader takes the values */
+    timespec_get(&start, TIME_UTC);
+    if (parse_csv_values(input_info->ibuff, strlen(input_info->ibuff), &values, &samples, NULL) || samples < 2) {
+        free(values);
+
+        return 1;
+    }
+
+    input_info->probe_data = values;
+    input_info->data_samples = samples;
+    input_info->channels = 1;
+    input_info->text_bytes = strlen(input_info->ibuff);
+    input_info->text_seconds = get_seconds_since(&start);
+
+    return 0;
+}
+
+int check_csv_extension(char* restrict extension)
+{
+    const int supported_csv_ext_num = 2;
+    char* supported_csv_ext[] = {".csv", ".txt"};
+    uint8_t supported_flag = 0;
+    
+    for (int i = 0; i < supported_csv_ext_num; i++) {
+        if (!strcmp(supported_csv_ext[i], extension)) {
+            supported_flag = 1;
+        }
+    }
+
+    if (!supported_flag) {
+        return 1;
+    }
+
+    return 0;
+}
+
+int check_raw_extension(char* restrict extension)
+{
+    const char* supported_raw_ext[] = {".raw", ".bin", ".pcm"};
+
+    for (size_t i = 0; i < sizeof(supported_raw_ext) / sizeof(supported_raw_ext[0]); i++) {
+        if (!strcmp(supported_raw_ext[i], extension)) {
+            return 0;
+        }
+    }
+
+    return 1;
+}
+
+uint8_t check_text_input(char input_type)
+{
+    return input_type == CSV_TYPE_CHAR || input_type == STR_TYPE_CHAR;
+}
+
+int set_raw_input(conv_config_t* restrict conv_conf, input_info_t* restrict input_info)
+{
+    struct stat st;
+
+    if (input_info->input_type != RAW_TYPE_CHAR) {
+        return 0;
+    }
+
+    if (!conv_conf->raw_format) {
+        fprintf(stderr, "\nRaw input '%s' needs its sample type from '--raw-dtype'.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    if (stat(input_info->ibuff, &st)) {
+        fprintf(stderr, "\nUnable to open raw input '%s'.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    input_info->samples.format = conv_conf->raw_format;
+    input_info->channels = conv_conf->raw_channels;
+    input_info->data_samples = st.st_size / (get_sample_bytes(conv_conf->raw_format) * input_info->channels);
+
+    return 0;
+}
+
+int read_raw_input(input_info_t* restrict input_info, SF_INFO* restrict sf_info, double** restrict x)
+{
+    const uint16_t byte_order = 1;
+    const size_t frame_bytes = get_sample_bytes(input_info->samples.format) * input_info->channels;
+
+    /* The samples are used as they are, so they have to be in host byte order */
+    if (*(const uint8_t*)&byte_order != 1) {
+        fprintf(stderr, "\nRaw input '%s' is little-endian and can only be read on little-endian hosts.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    if (map_file(input_info->ibuff, &input_info->map)) {
+        fprintf(stderr, "\nUnable to map raw input '%s'.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    /* A partial frame at the end is left out */
+    input_info->data_samples = input_info->map.size / frame_bytes;
+    if (!input_info->data_samples) {
+        fprintf(stderr, "\nRaw input '%s' has no complete frames.\n", input_info->ibuff);
+        unmap_file(&input_info->map);
+
+        return 1;
+    }
+
+    input_info->samples.data = input_info->map.data;
+    *x = NULL;
+
+    return 0;
 }
 
-int get_audio_file_data(SNDFILE* restrict file, SF_INFO* restrict sf_info, double** restrict x)
+int read_npy_input(input_info_t* restrict input_info, SF_INFO* restrict sf_info, double** restrict x)
 {
-    /* Get audio file data size */
-    *x = calloc(sf_info->frames * sf_info->channels, sizeof(double));
+    const uint16_t byte_order = 1;
+    size_t data_offset = 0;
+    int format = 0;
 
-    /* Read data and place into buffer */
-    sf_count_t sf_count = sf_readf_double(file, *x, sf_info->frames);
+    if (*(const uint8_t*)&byte_order != 1) {
+        fprintf(stderr, "\nNumPy input '%s' can only be read on little-endian hosts.\n", input_info->ibuff);
 
-    /* Check */
-    if (sf_count != sf_info->frames) {
-        fprintf(stderr, "\nRead count not equal to requested frames, %lld != %lld.\n", sf_count, sf_info->frames);
+        return 1;
+    }
+
+    /* The probe leaves the array mapped */
+    if (input_info->samples.data) {
+        if (x) {
+            *x = NULL;
+        }
+
+        return 0;
+    }
+
+    if (map_file(input_info->ibuff, &input_info->map)) {
+        fprintf(stderr, "\nUnable to map NumPy input '%s'.\n", input_info->ibuff);
+
+        return 1;
+    }
+
+    if (parse_npy_header(input_info->map.data, input_info->map.size, &format, &input_info->data_samples, &input_info->channels, &data_offset)) {
+        fprintf(stderr, "\nNumPy input '%s' is not a C ordered (frames,) or (frames, channels) array of little-endian 'f8', 'f4', 'i2', or 'i4'.\n", input_info->ibuff);
+        unmap_file(&input_info->map);
 
         return 1;
     }
 
+    input_info->samples.data = (const char*)input_info->map.data + data_offset;
+    input_info->samples.format = format;
+    if (x) {
+        *x = NULL;
+    }
+
     return 0;
 }
 
-void show_input_info(input_info_t* restrict input_info, SF_INFO* restrict sf_info)
+int parse_npy_header(const unsigned char* restrict data, size_t size, int* restrict format, size_t* restrict frames, uint8_t* restrict channels, size_t* restrict data_offset)
 {
-        if (input_info->input_type == 'a') {
-            fprintf(stdout, "File Name: %s\n", input_info->ibuff);
-            fprintf(stdout, "Sample Rate: %d\n", sf_info->samplerate);
-            fprintf(stdout, "Samples: %lld\n", sf_info->frames);
-            fprintf(stdout, "Channels: %d\n", sf_info->channels);
-            fprintf(stdout, "Format: %s\n", get_sndfile_major_format(sf_info));
-            fprintf(stdout, "Subtype: %s\n", get_sndfile_subtype(sf_info));
+    const char* descrs[] = {"<f8", "<f4", "<i2", "<i4"};
+    const int formats[] = {SF_FORMAT_DOUBLE, SF_FORMAT_FLOAT, SF_FORMAT_PCM_16, SF_FORMAT_PCM_32};
+    char dict[MAX_STR];
+    size_t header_size = 0;
+    size_t dict_size = 0;
+    unsigned long long dims[2] = {0, 1};
+    int dim_count = 0;
+
+    if (size < NPY_PREAMBLE_LEN || memcmp(data, NPY_MAGIC, NPY_MAGIC_LEN)) {
+        return 1;
+    }
+
+    /* Version 1 has a 16-bit header length, later versions a 32-bit one */
+    if (data[6] == 1) {
+        dict_size = data[8] | data[9] << 8;
+        header_size = NPY_PREAMBLE_LEN;
+    } else if (size >= NPY_PREAMBLE_LEN + 2) {
+        dict_size = data[8] | data[9] << 8 | data[10] << 16 | (uint32_t)data[11] << 24;
+        header_size = NPY_PREAMBLE_LEN + 2;
+    }
+    if (!dict_size || dict_size >= MAX_STR || header_size + dict_size > size) {
+        return 1;
+    }
+    memcpy(dict, data + header_size, dict_size);
+    dict[dict_size] = '\0';
+    *data_offset = header_size + dict_size;
+
+    char* descr = strstr(dict, "'descr':");
+    char* order = strstr(dict, "'fortran_order':");
+    char* shape = strstr(dict, "'shape':");
+    if (!descr || !order || !shape) {
+        return 1;
+    }
+
+    *format = 0;
+    descr = strchr(descr + strlen("'descr':"), '\'');
+    for (size_t i = 0; descr && i < sizeof(formats) / sizeof(formats[0]); i++) {
+        if (!strncmp(descr + 1, descrs[i], strlen(descrs[i])) && descr[1 + strlen(descrs[i])] == '\'') {
+            *format = formats[i];
+        }
+    }
+
+    shape = strchr(shape, '(');
+    if (!shape) {
+        return 1;
+    }
+    for (char* pos = shape + 1; dim_count < 3; dim_count++) {
+        char* end = NULL;
+        const unsigned long long dim = strtoull(pos, &end, 10);
+        if (end == pos) {
+            break;
+        }
+        if (dim_count < 2) {
+            dims[dim_count] = dim;
+        }
+        pos = end + strspn(end, " ,");
+    }
+
+    /* Interleaved frames are a C ordered array of frames by channels */
+    const uint8_t fortran_flag = !strncmp(order + strlen("'fortran_order':") + strspn(order + strlen("'fortran_order':"), " "), "True", 4);
+    if (!*format || dim_count < 1 || dim_count > 2 || !dims[0] || !dims[1] || dims[1] > UINT8_MAX || (fortran_flag && dims[1] > 1)) {
+        return 1;
+    }
+
+    *frames = dims[0];
+    *channels = dims[1];
+    if (*data_offset + *frames * *channels * get_sample_bytes(*format) > size) {
+        return 1;
+    }
+
+    return 0;
+}
+
+int read_csv_string_file_input(input_info_t* restrict input_data, SF_INFO* restrict sf_info, double** restrict x)
+{
+    mapped_file_t map;
+    struct timespec start;
+    int ret = 0;
+
+    /* CSV strings were parsed by the probe */
+    if (input_data->probe_data) {
+        *x = input_data->probe_data;
+        input_data->probe_data = NULL;
+
+        if (input_data->matrix_flag) {
+            CHECK_RET(set_matrix_layout(input_data, input_data->ibuff, strlen(input_data->ibuff)));
+        }
+
+        return set_csv_layout(input_data);
+    }
+
+    timespec_get(&start, TIME_UTC);
+
+    /* Parse files in place, and strings as they are */
+    if (input_data->input_type == CSV_TYPE_CHAR) {
+        if (map_file(input_data->ibuff, &map)) {
+            fprintf(stderr, "\nUnable to read CSV file '%s', it is missing or empty.\n", input_data->ibuff);
+
+            return 1;
+        }
+
+        input_data->text_bytes = map.size;
+        ret = parse_csv_data(map.data, map.size, x, &input_data->data_samples, input_data->ibuff, input_data->threads);
+        if (!ret && input_data->matrix_flag) {
+            ret = set_matrix_layout(input_data, map.data, map.size);
+        }
+        unmap_file(&map);
+    } else {
+        input_data->text_bytes = strlen(input_data->ibuff);
+        ret = parse_csv_data(input_data->ibuff, input_data->text_bytes, x, &input_data->data_samples, input_data->ibuff, 1);
+        if (!ret && input_data->matrix_flag) {
+            ret = set_matrix_layout(input_data, input_data->ibuff, input_data->text_bytes);
+        }
+    }
+
+    input_data->text_seconds = get_seconds_since(&start);
+
+    return ret ? ret : set_csv_layout(input_data);
+}
+
+int set_csv_layout(input_info_t* restrict input_info)
+{
+    input_info->channels = 1;
+    if (!input_info->complex_flag) {
+        return 0;
+    }
+
+    /* Complex values are I,Q pairs, one pair per row of a two column file */
+    if (input_info->data_samples % 2) {
+        fprintf(stderr, "\nComplex CSV input '%s' has an odd number of values, it needs I,Q pairs.\n", input_info->ibuff);
+
+        return 1;
+    }
+    input_info->channels = 2;
+    input_info->data_samples /= 2;
+
+    return 0;
+}
+
+int set_matrix_layout(input_info_t* restrict input_info, const char* restrict data, size_t size)
+{
+    const char* end = data + size;
+    size_t columns = 0;
+    size_t rows = 0;
+
+    for (const char* pos = data; pos < end; pos++) {
+        size_t values = 0;
+        uint8_t value_flag = 0;
+
+        /* Count the runs of characters between separators up to the end of the line */
+        for (; pos < end && *pos != '\n'; pos++) {
+            const uint8_t separator_flag = check_csv_separator(*pos);
+            values += !separator_flag && !value_flag;
+            value_flag = !separator_flag;
+        }
+
+        /* Blank lines are skipped */
+        if (!values) {
+            continue;
+        }
+
+        if (rows && values != columns) {
+            fprintf(stderr, "\nRow %zu of matrix '%s' has %zu values, the rows before it have %zu.\n", rows + 1, input_info->ibuff, values, columns);
+
+            return 1;
+        }
+        columns = values;
+        rows++;
+    }
+
+    if (rows * columns != input_info->data_samples) {
+        fprintf(stderr, "\nUnable to split '%s' into the rows of a matrix.\n", input_info->ibuff);
+
+        return 1;
+    }
+    input_info->rows = rows;
+
+    return 0;
+}
+
+int parse_csv_data(const char* restrict data, size_t size, double** restrict x, size_t* restrict detected_samples, const char* restrict name, uint16_t threads)
+{
+    if (!threads) {
+        threads = get_cpu_count();
+    }
+    if (threads > size / CSV_CHUNK_MIN_BYTES) {
+        threads = size / CSV_CHUNK_MIN_BYTES;
+    }
+
+    *x = NULL;
+    int ret = threads > 1 ? parse_csv_parallel(data, size, x, detected_samples, name, threads) : parse_csv_values(data, size, x, detected_samples, name);
+    if (ret) {
+        free(*x);
+        *x = NULL;
+
+        return 1;
+    }
+
+    if (!*detected_samples) {
+        fprintf(stderr, "\nNo values found in '%s'.\n", name);
+        free(*x);
+        *x = NULL;
+
+        return 1;
+    }
+
+    return 0;
+}
+
+int parse_csv_values(const char* restrict data, size_t size, double** restrict x, size_t* restrict detected_samples, const char* restrict name)
+{
+    const char* pos = data;
+    const char* end = data + size;
+    size_t capacity = CSV_MIN_CAPACITY;
+    size_t samples = 0;
+
+    *x = malloc(capacity * sizeof(double));
+    if (!*x) {
+        fprintf(stderr, "\nUnable to allocate the samples of '%s'.\n", name);
+
+        return 1;
+    }
+
+    for (;;) {
+        while (pos < end && check_csv_separator(*pos)) {
+            pos++;
+        }
+        if (pos == end) {
+            break;
+        }
+
+        const char* token = pos;
+        while (pos < end && !check_csv_separator(*pos)) {
+            pos++;
+        }
+
+        /* Double the buffer when it fills */
+        if (samples == capacity) {
+            double* grown = realloc(*x, 2 * capacity * sizeof(double));
+            if (!grown) {
+                fprintf(stderr, "\nUnable to allocate the samples of '%s'.\n", name);
+
+                return 1;
+            }
+            *x = grown;
+            capacity *= 2;
+        }
+
+        if (parse_double(token, pos, &(*x)[samples])) {
+            if (name) {
+                fprintf(stderr, "\nValue '%.*s' in '%s' is not a number.\n", (int)(pos - token < MAX_TOKEN_CHARS ? pos - token : MAX_TOKEN_CHARS), token, name);
+            }
+
+            return 1;
+        }
+        samples++;
+    }
+
+    /* Give back what the doubling over-allocated */
+    double* shrunk = samples ? realloc(*x, samples * sizeof(double)) : NULL;
+    if (shrunk) {
+        *x = shrunk;
+    }
+
+    *detected_samples = samples;
+
+    return 0;
+}
+
+int parse_csv_parallel(const char* restrict data, size_t size, double** restrict x, size_t* restrict detected_samples, const char* restrict name, uint16_t threads)
+{
+    csv_chunk_t* chunks = calloc(threads, sizeof(csv_chunk_t));
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    uint8_t* started = calloc(threads, sizeof(uint8_t));
+    int ret = 1;
+
+    if (!chunks || !workers || !started) {
+        fprintf(stderr, "\nUnable to allocate the samples of '%s'.\n", name);
+        free(chunks);
+        free(workers);
+        free(started);
+
+        return 1;
+    }
+
+    /* Move every split forward to a separator so no value is cut in two */
+    size_t start = 0;
+    for (uint16_t t = 0; t < threads; t++) {
+        size_t stop = t + 1 < threads ? (size_t)((double)size * (t + 1) / threads) : size;
+        if (stop < start) {
+            stop = start;
+        }
+        while (stop < size && !check_csv_separator(data[stop])) {
+            stop++;
+        }
+
+        chunks[t].data = data + start;
+        chunks[t].size = stop - start;
+        chunks[t].name = name;
+        start = stop;
+    }
+
+    /* Parse a chunk on the calling thread if its worker could not be started */
+    for (uint16_t t = 0; t < threads; t++) {
+        started[t] = !pthread_create(&workers[t], NULL, &csv_chunk_worker, &chunks[t]);
+        if (!started[t]) {
+            csv_chunk_worker(&chunks[t]);
+        }
+    }
+
+    size_t samples = 0;
+    uint8_t failed_flag = 0;
+    for (uint16_t t = 0; t < threads; t++) {
+        if (started[t]) {
+            pthread_join(workers[t], NULL);
+        }
+        failed_flag |= chunks[t].ret;
+        samples += chunks[t].samples;
+    }
+
+    /* The prefix sum of the chunk counts places every chunk in the combined buffer */
+    if (!failed_flag) {
+        *x = malloc((samples ? samples : 1) * sizeof(double));
+        if (*x) {
+            size_t offset = 0;
+            for (uint16_t t = 0; t < threads; t++) {
+                if (chunks[t].samples) {
+                    memcpy(*x + offset, chunks[t].x, chunks[t].samples * sizeof(double));
+                }
+                offset += chunks[t].samples;
+            }
+
+            *detected_samples = samples;
+            ret = 0;
         } else {
-            fprintf(stdout, input_info->input_type == 'c' ? "File Name: %s\n" : "Input String: %s\n", input_info->ibuff);
-            fprintf(stdout, "Samples: %lld\n", input_info->data_samples);
-            fprintf(stdout, input_info->input_type == 'c' ? "Format: CSV File\n" : "Format: CSV String\n");
+            fprintf(stderr, "\nUnable to allocate the samples of '%s'.\n", name);
+        }
+    }
+
+    for (uint16_t t = 0; t < threads; t++) {
+        free(chunks[t].x);
+    }
+    free(chunks);
+    free(workers);
+    free(started);
+    return ret;
+}
+
+void* csv_chunk_worker(void* arg)
+{
+    csv_chunk_t* chunk = arg;
+
+    chunk->ret = parse_csv_values(chunk->data, chunk->size, &chunk->x, &chunk->samples, chunk->name);
+
+    return NULL;
+}
+
+int parse_double(const char* restrict start, const char* restrict end, double* restrict value)
+{
+    const char* pos = start;
+    uint64_t mantissa = 0;
+    int digits = 0;
+    int exponent = 0;
+    uint8_t negative = 0;
+
+    if (pos < end && (*pos == '-' || *pos == '+')) {
+        negative = *pos == '-';
+        pos++;
+    }
+
+    /* Leading zeros do not count towards the 19 digits a 64-bit mantissa holds */
+    const char* digits_start = pos;
+    while (pos < end && *pos == '0') {
+        pos++;
+    }
+    for (; pos < end && *pos >= '0' && *pos <= '9'; pos++, digits++) {
+        mantissa = 10 * mantissa + (*pos - '0');
+    }
+    uint8_t digit_flag = pos > digits_start;
+    if (pos < end && *pos == '.') {
+        pos++;
+        const char* frac_start = pos;
+        if (!mantissa) {
+            while (pos < end && *pos == '0') {
+                pos++;
+                exponent--;
+            }
+        }
+        for (; pos < end && *pos >= '0' && *pos <= '9'; pos++, digits++, exponent--) {
+            mantissa = 10 * mantissa + (*pos - '0');
+        }
+        digit_flag |= pos > frac_start;
+    }
+    if (digit_flag && pos < end && (*pos == 'e' || *pos == 'E')) {
+        const char* exp_start = ++pos;
+        int exp_sign = 1;
+        int exp_value = 0;
+
+        if (pos < end && (*pos == '-' || *pos == '+')) {
+            exp_sign = *pos == '-' ? -1 : 1;
+            pos++;
+        }
+        for (; pos < end && *pos >= '0' && *pos <= '9' && exp_value < 100000; pos++) {
+            exp_value = 10 * exp_value + (*pos - '0');
+        }
+        if (pos == exp_start || (pos == exp_start + 1 && (*exp_start == '-' || *exp_start == '+'))) {
+            digit_flag = 0;
+        }
+        exponent += exp_sign * exp_value;
+    }
+
+    /* Both the mantissa and the power of ten are exact, so one multiply or divide rounds correctly */
+    if (digit_flag && pos == end && digits <= 19 && mantissa <= MAX_EXACT_MANTISSA && exponent >= -MAX_EXACT_POW10 && exponent <= MAX_EXACT_POW10) {
+        *value = exponent < 0 ? mantissa / get_exact_pow10(-exponent) : mantissa * get_exact_pow10(exponent);
+        if (negative) {
+            *value = -*value;
+        }
+
+        return 0;
+    }
+
+    /* Long mantissas, large exponents, 'inf', and 'nan' */
+    char token[MAX_TOKEN_CHARS + 1];
+    char* token_end = NULL;
+    const size_t len = end - start;
+    if (len > MAX_TOKEN_CHARS) {
+        return 1;
+    }
+    memcpy(token, start, len);
+    token[len] = '\0';
+    *value = strtod(token, &token_end);
+
+    return !len || *token_end != '\0';
+}
+
+double get_exact_pow10(uint8_t exponent)
+{
+    static const double powers[MAX_EXACT_POW10 + 1] = {1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+    return powers[exponent];
+}
+
+double get_output_scale(conv_config_t* restrict conv_conf)
+{
+    /* A silent output is left as it is */
+    if (conv_conf->norm_bound_flag && conv_conf->norm_bound > 0.0) {
+        return 1.0 / conv_conf->norm_bound;
+    }
+    if (conv_conf->norm_flag && conv_conf->stats.peak > 0.0) {
+        return 1.0 / conv_conf->stats.peak;
+    }
+
+    return 1.0;
+}
+
+void show_output_level(conv_config_t* restrict conv_conf, FILE* restrict file)
+{
+    const double samples = (double)conv_conf->total_samples * conv_conf->channels;
+    const double rms = samples > 0.0 ? sqrt(conv_conf->stats.energy / samples) : 0.0;
+
+    if (conv_conf->info_flag) {
+        fprintf(file, "Output peak %lf (%.2lf dBFS), RMS %lf (%.2lf dBFS).\n", conv_conf->stats.peak, 20.0 * log10(conv_conf->stats.peak), rms, 20.0 * log10(rms));
+    }
+
+    /* The bound holds for any input with the same peaks and absolute sums, so a real output peaks below it */
+    if (conv_conf->norm_bound_flag) {
+        fprintf(file, "Output peak bound %lf, the output peaks at %lf of it, costing %.2lf dB of headroom.\n", conv_conf->norm_bound,
+                conv_conf->stats.peak * get_output_scale(conv_conf), 20.0 * log10(conv_conf->norm_bound / conv_conf->stats.peak));
+    }
+}
+
+int set_norm_bound(conv_config_t* restrict conv_conf, SNDFILE* restrict file_x, double* restrict x, SNDFILE* restrict file_h, double* restrict h)
+{
+    input_info_t* info_x = &conv_conf->input_info[X_INDEX];
+    input_info_t* info_h = &conv_conf->input_info[H_INDEX];
+    const uint8_t channels = info_x->channels > info_h->channels ? info_x->channels : info_h->channels;
+    double* peak_x = calloc(info_x->channels, sizeof(double));
+    double* sum_h = calloc(info_h->channels, sizeof(double));
+    int ret = 0;
+
+    if (!peak_x || !sum_h) {
+        fprintf(stderr, "\nUnable to allocate the peak bound.\n");
+        free(peak_x);
+        free(sum_h);
+
+        return 1;
+    }
+
+    /* A stream is only known to stay within full scale */
+    if (file_x) {
+        ret = scan_file_levels(file_x, info_x->channels, peak_x, NULL);
+    } else if (conv_conf->stream_flag) {
+        for (uint8_t c = 0; c < info_x->channels; c++) {
+            peak_x[c] = 1.0;
         }
+    } else {
+        add_channel_levels(get_input_samples(info_x, x), info_x->data_samples, info_x->channels, peak_x, NULL);
+    }
+
+    if (file_h) {
+        ret = ret || scan_file_levels(file_h, info_h->channels, NULL, sum_h);
+    } else {
+        add_channel_levels(get_input_samples(info_h, h), info_h->data_samples, info_h->channels, NULL, sum_h);
+    }
+
+    conv_conf->norm_bound = 0.0;
+    for (uint8_t c = 0; c < channels; c++) {
+        const double bound = peak_x[c % info_x->channels] * sum_h[c % info_h->channels];
+
+        conv_conf->norm_bound = bound > conv_conf->norm_bound ? bound : conv_conf->norm_bound;
+    }
+    conv_conf->scale = get_output_scale(conv_conf);
+
+    if (ret) {
+        fprintf(stderr, "\nUnable to read the inputs for the peak bound.\n");
+    }
 
+    free(peak_x);
+    free(sum_h);
+    return ret;
 }
 
-const char* get_sndfile_major_format(SF_INFO* restrict sf_info)
+void add_channel_levels(samples_t x, size_t frames, uint8_t channels, double* restrict peak, double* restrict sum)
 {
-    SF_FORMAT_INFO format_info ;
-    int k, count;
-    const uint32_t format_mask = 0x00FF0000;
-    const uint32_t major_format = sf_info->format & format_mask;
-
-    sf_command(NULL, SFC_GET_FORMAT_MAJOR_COUNT, &count, sizeof (int));
+    for (size_t n = 0; n < frames; n++) {
+        for (uint8_t c = 0; c < channels; c++) {
+            const double abs_x = fabs(get_sample(x, n * channels + c));
 
-    for (k = 0 ; k < count ; k++) {
-        format_info.format = k;
-        sf_command(NULL, SFC_GET_FORMAT_MAJOR, &format_info, sizeof(format_info));
-        if (major_format == format_info.format) {
-            return format_info.name;
+            if (peak && abs_x > peak[c]) {
+                peak[c] = abs_x;
+            }
+            if (sum) {
+                sum[c] += abs_x;
+            }
         }
     }
-
-    return "N/A";
 }
 
-const char* get_sndfile_subtype(SF_INFO* restrict sf_info)
+int scan_file_levels(SNDFILE* restrict file, uint8_t channels, double* restrict peak, double* restrict sum)
 {
-    SF_FORMAT_INFO format_info ;
-    int k, count;
-    const uint16_t subtype_mask = 0x00FF;
-    const uint16_t subtype = sf_info->format & subtype_mask;
+    const size_t chunk = SCALE_CHUNK_SAMPLES / channels;
+    sf_count_t frames = 0;
 
-    sf_command(NULL, SFC_GET_FORMAT_SUBTYPE_COUNT, &count, sizeof (int));
+    double* buf = malloc(chunk * channels * sizeof(double));
+    if (!buf) {
+        return 1;
+    }
 
-    for (k = 0 ; k < count ; k++) {
-        format_info.format = k;
-        sf_command(NULL, SFC_GET_FORMAT_SUBTYPE, &format_info, sizeof(format_info));
-        if (subtype == format_info.format) {
-            return format_info.name;
-        }
+    while ((frames = sf_readf_double(file, buf, chunk)) > 0) {
+        add_channel_levels(double_samples(buf), frames, channels, peak, sum);
     }
 
-    return "N/A";
+    free(buf);
+    return sf_seek(file, 0, SEEK_SET) != 0;
 }
 
-int check_csv_string(char* restrict ibuff)
+int write_output(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info_x, SF_INFO* restrict sf_info_h, double* restrict y)
 {
-    /* Make a copy of the string to get the number of data points  */
-    char* data_string_copy = calloc(strlen(ibuff), sizeof(char)); 
-    strcpy(data_string_copy, ibuff);
+    SF_INFO sf_info_y = {0};
+    int (*outp)(conv_config_t*, SF_INFO*, double*) = conv_conf->outp;
 
-    /* Get the number of data points */
-    size_t samples = 0;
-    char* token = strtok(data_string_copy, ",");
-    while (token != NULL) {
-        samples++;
-        token = strtok(NULL, ",");
+    /* If no output type is specified, set it based on inputs */
+    if (outp == NULL) {
+        outp = autoset_output_format(conv_conf->input_info[X_INDEX].input_type, conv_conf->input_info[H_INDEX].input_type);
+    }
+
+    /* Normalising only sets the scale, the writers apply it as they convert y[n] */
+    conv_conf->scale = get_output_scale(conv_conf);
+    if (!conv_conf->quiet_flag) {
+        show_output_level(conv_conf, stdout);
     }
 
-    free(data_string_copy);
+    /* Generate the output file name, the container only names audio outputs */
+    generate_file_name(conv_conf->ofile, conv_conf->input_info, conv_conf->input_flag, outp == &output_file_audio ? conv_conf->out_extension : NULL);
 
-    if (samples > 1) {
-        return 0;
-    } else {
-        return 1;
+    if (sf_info_x->format != 0) {
+        sf_info_y = *sf_info_x;
+    } else if (sf_info_h->format != 0) {
+        sf_info_y = *sf_info_h;
     }
+    sf_info_y.channels = conv_conf->channels;
+
+    /* Output to specified buffer */
+    return outp(conv_conf, &sf_info_y, y);
 }
 
-int check_csv_extension(char* restrict extension)
+int output_file_audio(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info, double* restrict x)
 {
-    const int supported_csv_ext_num = 2;
-    char* supported_csv_ext[] = {".csv", ".txt"};
-    uint8_t supported_flag = 0;
-    
-    for (int i = 0; i < supported_csv_ext_num; i++) {
-        if (!strcmp(supported_csv_ext[i], extension)) {
-            supported_flag = 1;
-        }
+    CHECK_RET(set_output_format(conv_conf, sf_info));
+
+    SNDFILE* sndfile = sf_open(conv_conf->ofile, SFM_WRITE, sf_info);
+    if(!(sndfile)) {
+        fprintf(stderr, "%s\n", sf_strerror(sndfile));
+
+        return 1;
     }
 
-    if (!supported_flag) {
+    quantizer_t* quantizer = create_quantizer(sf_info->format & SF_FORMAT_SUBMASK, 0);
+    if (!quantizer || write_audio_frames(conv_conf, sndfile, quantizer, x, conv_conf->total_samples)) {
+        fprintf(stderr, "\nUnable to write the output to '%s'.\n", conv_conf->ofile);
+        destroy_quantizer(quantizer);
+        sf_close(sndfile);
+
         return 1;
     }
 
+    report_clipping(quantizer);
+    destroy_quantizer(quantizer);
+    sf_close(sndfile);
+    printf("Saved result to '%s'.\n", conv_conf->ofile);
     return 0;
 }
 
-int read_csv_string_file_input(input_info_t* restrict input_data, SF_INFO* restrict sf_info, double** restrict x)
+quantizer_t* create_quantizer(int format, uint8_t clip_flag)
 {
-    FILE* file = NULL;          // Pointer to the input audio file
-    char* data_string = NULL;   // Input data from file
+    quantizer_t* quantizer = calloc(1, sizeof(quantizer_t));
+    if (!quantizer) {
+        return NULL;
+    }
 
-    /* Try to open and read input file, if not then it's considered a data string */
-    if (!(open_csv_file(&file, input_data->ibuff))) {
-        CHECK_ERR(read_csv_file_data(file, &data_string));
-        // input_data->input_flag = 0;
-    } else {
-        data_string = calloc(strlen(input_data->ibuff) + 1, sizeof(char)); 
-        strcpy(data_string, input_data->ibuff);
-        // input_data->input_flag = 1;
+    quantizer->format = format;
+    quantizer->seed = DITHER_SEED;
+    quantizer->step = 1;
+
+    /* Full scale is the largest sample, the same as libsndfile's own double to PCM conversion without clipping */
+    switch (format) {
+        case SF_FORMAT_PCM_16:
+            quantizer->gain = INT16_MAX;
+            break;
+        case SF_FORMAT_PCM_24:
+            quantizer->gain = 0x7FFFFF;
+            quantizer->step = 256;
+            break;
+        case SF_FORMAT_PCM_32:
+            quantizer->gain = INT32_MAX;
+            break;
+        default:
+            quantizer->format = 0;
+            break;
     }
+    quantizer->min = -quantizer->gain - 1.0;
+    quantizer->max = quantizer->gain;
 
-    get_data_from_string(data_string, x, &input_data->data_samples);
+    /* Clipping moves full scale to the most negative sample */
+    if (clip_flag) {
+        quantizer->gain = -quantizer->min;
+    }
 
-    /* Output info on the inputted file */
-    // show_input_csv_info(input_data);
+    /* Doubles only need the buffer when they are scaled */
+    quantizer->buf = malloc(SCALE_CHUNK_SAMPLES * sizeof(double));
+    /* Without dithering the noise stays zero */
+    quantizer->noise = quantizer->format ? calloc(SCALE_CHUNK_SAMPLES, sizeof(double)) : NULL;
+    if (!quantizer->buf || (quantizer->format && !quantizer->noise)) {
+        destroy_quantizer(quantizer);
 
-    free(data_string);
-    fclose(file);
-    return 0;
+        return NULL;
+    }
+
+    return quantizer;
 }
 
-int open_csv_file(FILE** restrict file, char* restrict ibuff)
+void destroy_quantizer(quantizer_t* quantizer)
 {
-    *file = fopen(ibuff, "r");
-    if(!(*file)) {
+    if (!quantizer) {
+        return;
+    }
 
-        return 1;
+    free(quantizer->buf);
+    free(quantizer->noise);
+    free(quantizer);
+}
+
+void report_clipping(quantizer_t* quantizer)
+{
+    if (quantizer->clipped) {
+        fprintf(stderr, "Clipped %zu output samples, '--norm' or '--norm-bound' keeps them in range.\n", quantizer->clipped);
+    }
+}
+
+int write_audio_frames(conv_config_t* restrict conv_conf, SNDFILE* restrict file, quantizer_t* restrict quantizer, double* restrict y, size_t frames)
+{
+    const uint8_t channels = conv_conf->channels;
+    const size_t chunk = SCALE_CHUNK_SAMPLES / channels;
+    const double gain = quantizer->gain * conv_conf->scale;
+    sf_count_t written = 0;
+
+    /* Unscaled doubles go out as they are */
+    if (!quantizer->format && conv_conf->scale == 1.0) {
+        return sf_writef_double(file, y, frames) != (sf_count_t)frames;
+    }
+
+    for (size_t start = 0; start < frames; start += chunk) {
+        const size_t count = frames - start < chunk ? frames - start : chunk;
+        const double* x = y + start * channels;
+
+        if (quantizer->format && conv_conf->dither_flag) {
+            fill_dither(quantizer, count * channels);
+        }
+
+        switch (quantizer->format) {
+            case SF_FORMAT_PCM_16:
+                quantizer->clipped += quantize_short(x, count * channels, gain, quantizer->noise, quantizer->buf);
+                written = sf_writef_short(file, quantizer->buf, count);
+                break;
+            case SF_FORMAT_PCM_24:
+            case SF_FORMAT_PCM_32:
+                quantizer->clipped += quantize_int(x, count * channels, gain, quantizer->noise, quantizer->min, quantizer->max, quantizer->step, quantizer->buf);
+                written = sf_writef_int(file, quantizer->buf, count);
+                break;
+            default:
+                for (size_t i = 0; i < count * channels; i++) {
+                    ((double*)quantizer->buf)[i] = x[i] * conv_conf->scale;
+                }
+                written = sf_writef_double(file, quantizer->buf, count);
+                break;
+        }
+
+        if (written != (sf_count_t)count) {
+            return 1;
+        }
     }
 
     return 0;
 }
 
-int read_csv_file_data(FILE* restrict file, char** restrict data_string)
+void fill_dither(quantizer_t* restrict quantizer, size_t count)
 {
-    /* Go to the end of the file to find the size needed to store the data */
-    fseek(file, 0, SEEK_END);
+    uint64_t seed = quantizer->seed;
 
-    long pos = ftell(file);
+    /* xorshift64*, each draw gives the two uniform values */
+    for (size_t i = 0; i < count; i++) {
+        seed ^= seed >> 12;
+        seed ^= seed << 25;
+        seed ^= seed >> 27;
 
-    /* Put the file position indicator back to the start */
-    long ret = fseek(file, 0, SEEK_SET);
-    if (ret == -1L || pos < 0) {
-        fprintf(stderr, "Error when trying to read CSV file data.\n");
-
-        return 1;
+        const uint64_t r = seed * 0x2545F4914F6CDD1DULL;
+        quantizer->noise[i] = ((double)(uint32_t)r - (double)(uint32_t)(r >> 32)) * 0x1p-32;
     }
 
-    /* Allocate the file size */
-    *data_string = calloc(pos + 1, sizeof(char));
+    quantizer->seed = seed;
+}
+
+size_t quantize_short(const double* restrict x, size_t count, double gain, const double* restrict noise, int16_t* restrict out)
+{
+    size_t clipped = 0;
 
-    /* Read the file data and place into string variable */
-    fgets(*data_string, pos + 1, file);
+    for (size_t i = 0; i < count; i++) {
+        const double v = x[i] * gain + noise[i];
 
-    return 0;
+        clipped += (v > -INT16_MIN + 1.0) | (v < INT16_MIN - 1.0);
+        out[i] = (int16_t)round_sample(v, INT16_MIN, INT16_MAX);
+    }
+
+    return clipped;
 }
 
-int get_data_from_string(char* restrict data_string, double** restrict x, size_t* restrict detected_samples)
+size_t quantize_int(const double* restrict x, size_t count, double gain, const double* restrict noise, double min, double max, int32_t step, int32_t* restrict out)
 {
-    /* Make a copy of the string to get the number of data points  */
-    char* data_string_copy = malloc(sizeof(char) * strlen(data_string)); 
-    strcpy(data_string_copy, data_string);
+    size_t clipped = 0;
 
-    /* Get the number of data points */
-    size_t samples = 0;
-    char* token = strtok(data_string_copy, ",");
-    while (token != NULL) {
-        samples++;
-        token = strtok(NULL, ",");
+    for (size_t i = 0; i < count; i++) {
+        const double v = x[i] * gain + noise[i];
+
+        clipped += (v > 1.0 - min) | (v < min - 1.0);
+        out[i] = (int32_t)round_sample(v, min, max) * step;
     }
 
-    /* Allocate the size of the array based on the data points */
-    *x = calloc(samples, sizeof(double));
+    return clipped;
+}
+
+int select_precision(conv_config_t* restrict conv_conf, char* strval)
+{
+    int dval = 0;
+
+    if (!(strcmp(SHORTEST_STR, strval))) {
+        conv_conf->precision = SHORTEST_PRECISION;
 
-    /* Retrieve the data */
-    size_t i = 0;
-    double lfval = 0.0f;
-    token = strtok(data_string, ",");
-    while (token != NULL && i < samples) {
-        sscanf(token, "%lf", &lfval);
-        (*x)[i] = lfval;
-        token = strtok(NULL, ",");
-        i++;
+        return 0;
     }
 
-    *detected_samples = samples;
-    free(data_string_copy);
+    if (sscanf(strval, "%d", &dval) != 1 || dval < 0 || dval >= SHORTEST_PRECISION) {
+        fprintf(stderr, "\nPrecision must be a number of decimal places from 0 to %d, or '%s'.\n", SHORTEST_PRECISION - 1, SHORTEST_STR);
+
+        return 1;
+    }
+    conv_conf->precision = dval;
 
     return 0;
 }
 
-void normalise_data(double* restrict x, size_t size)
+size_t format_sample(char* restrict buf, double value, uint8_t precision)
 {
-    double max_abs_val = 0;
-    double val = 0;
-    for (size_t i = 0; i < size; i++) {
-        if (x[i] > 0.0f) {
-            val = x[i];
-        } else {
-            val = -x[i];
-        }
-        if (val > max_abs_val) {
-            max_abs_val = val;
-        }
+    if (precision == SHORTEST_PRECISION) {
+        return format_shortest(buf, value);
     }
 
-    for (size_t i = 0; i < size; i++) {
-        x[i] /= max_abs_val;
-    }
+    return format_fixed(buf, value, precision);
 }
 
-int output_file_audio(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info, double* restrict x)
+size_t format_fixed(char* restrict buf, double value, uint8_t precision)
 {
-    SNDFILE* sndfile = sf_open(conv_conf->ofile, SFM_WRITE, sf_info);
-    if(!(sndfile)) {
-        fprintf(stderr, "%s\n", sf_strerror(sndfile));
+    const double scaled = precision <= MAX_EXACT_POW10 ? fabs(value) * get_exact_pow10(precision) : INFINITY;
 
-        return 1;
+    /* The product is within half an ulp of the exact one, so the rounding only needs printf() when it lands that close to a half */
+    const double whole = floor(scaled);
+    const double frac = scaled - whole;
+    if (!(scaled < FAST_MAX_SCALED) || fabs(frac - 0.5) <= scaled * DBL_EPSILON) {
+        return snprintf(buf, MAX_SAMPLE_CHARS, "%.*lf", precision, value);
     }
 
-    sf_write_double(sndfile, x, conv_conf->total_samples);
+    uint64_t digits = (uint64_t)whole + (frac > 0.5);
+    char tmp[32];
+    size_t len = 0;
+    size_t n = 0;
 
-    sf_close(sndfile);
-    printf("Saved result to '%s'.\n", conv_conf->ofile);
-    return 0;
+    /* Digits come out backwards, with at least one before the point */
+    do {
+        tmp[n++] = '0' + digits % 10;
+        digits /= 10;
+    } while (digits || n <= precision);
+
+    /* printf() keeps the sign of negative samples that round to zero */
+    if (signbit(value)) {
+        buf[len++] = '-';
+    }
+    while (n > precision) {
+        buf[len++] = tmp[--n];
+    }
+    if (precision) {
+        buf[len++] = '.';
+        while (n) {
+            buf[len++] = tmp[--n];
+        }
+    }
+
+    return len;
 }
 
-void set_precision_format(char format[9], uint8_t precision)
+size_t format_shortest(char* restrict buf, double value)
 {
-    sprintf(format, "%%.%dlf", precision);
+    int len = 0;
+
+    /* Any decimal with up to 15 digits survives the trip through a double, so only the last two lengths need checking */
+    for (int digits = DBL_DIG; digits < DBL_DECIMAL_DIG; digits++) {
+        len = snprintf(buf, MAX_SAMPLE_CHARS, "%.*g", digits, value);
+        if (strtod(buf, NULL) == value) {
+            return len;
+        }
+    }
+
+    return snprintf(buf, MAX_SAMPLE_CHARS, "%.*g", DBL_DECIMAL_DIG, value);
 }
 
 int output_stdout(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info, double* restrict x)
@@ -584,11 +5204,7 @@ int output_stdout(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info,
         fprintf(file, "\n");
     }
 
-    set_precision_format(conv_conf->format, conv_conf->precision);
-    for (size_t i = 0; i < conv_conf->total_samples; i++) {
-        fprintf(file, "%lf", x[i]);
-        fprintf(file, "\n");
-    }
+    write_columns(file, conv_conf, x);
 
     return 0;
 }
@@ -600,13 +5216,7 @@ int output_stdout_csv(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_in
         fprintf(file, "\n");
     }
 
-    set_precision_format(conv_conf->format, conv_conf->precision);
-    for (size_t i = 0; i < conv_conf->total_samples - 1; i++) {
-        fprintf(file, conv_conf->format, x[i]);
-        fprintf(file, ",");
-    }
-    fprintf(file, conv_conf->format, x[conv_conf->total_samples]);
-    fprintf(file, "\n");
+    write_csv_rows(file, conv_conf, x);
 
     return 0;
 }
@@ -620,11 +5230,7 @@ int output_file_columns(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_
         return 1;
     };
 
-    set_precision_format(conv_conf->format, conv_conf->precision);
-    for (size_t i = 0; i < conv_conf->total_samples; i++) {
-        fprintf(file, conv_conf->format, x[i]);
-        fprintf(file, "\n");
-    }
+    write_columns(file, conv_conf, x);
 
     if (!conv_conf->quiet_flag) {
         printf("Outputted data to '%s'.\n", conv_conf->ofile);
@@ -643,12 +5249,7 @@ int output_file_csv(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info
         return 1;
     };
 
-    set_precision_format(conv_conf->format, conv_conf->precision);
-    for (size_t i = 0; i < conv_conf->total_samples - 1; i++) {
-        fprintf(file, conv_conf->format, x[i]);
-        fprintf(file, ",");
-    }
-    fprintf(file, conv_conf->format, x[conv_conf->total_samples]);
+    write_csv_rows(file, conv_conf, x);
 
     if (!conv_conf->quiet_flag) {
         printf("Outputted data to '%s'.\n", conv_conf->ofile);
@@ -658,6 +5259,255 @@ int output_file_csv(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info
     return 0;
 }
 
+int output_file_raw_f64(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info, double* restrict x)
+{
+    return write_binary_output(conv_conf, NULL, 0, x, sizeof(double));
+}
+
+int output_file_raw_f32(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info, double* restrict x)
+{
+    return write_binary_output(conv_conf, NULL, 0, x, sizeof(float));
+}
+
+int output_file_npy(conv_config_t* restrict conv_conf, SF_INFO* restrict sf_info, double* restrict x)
+{
+    char header[NPY_MAX_HEADER];
+    const size_t header_size = conv_conf->columns ? make_npy_header(header, conv_conf->total_samples / conv_conf->columns, conv_conf->columns, 1) :
+        make_npy_header(header, conv_conf->total_samples, conv_conf->channels, 0);
+
+    return write_binary_output(conv_conf, header, header_size, x, sizeof(double));
+}
+
+size_t make_npy_header(char header[NPY_MAX_HEADER], size_t frames, size_t channels, uint8_t matrix_flag)
+{
+    const uint16_t byte_order = 1;
+    char shape[MIN_STR];
+    char dict[NPY_MAX_HEADER];
+
+    /* Interleaved frames are a C ordered array of frames by channels, a matrix keeps its rows by columns */
+    if (channels == 1 && !matrix_flag) {
+        sprintf(shape, "(%zu,)", frames);
+    } else {
+        sprintf(shape, "(%zu, %zu)", frames, channels);
+    }
+    int len = snprintf(dict, sizeof(dict), "{'descr': '%cf8', 'fortran_order': False, 'shape': %s, }", *(const uint8_t*)&byte_order == 1 ? '<' : '>', shape);
+
+    /* Version 1.0 header, padded with spaces and ended with a newline */
+    const size_t header_size = (NPY_PREAMBLE_LEN + len + 1 + NPY_ALIGN - 1) / NPY_ALIGN * NPY_ALIGN;
+    const uint16_t dict_size = header_size - NPY_PREAMBLE_LEN;
+
+    memcpy(header, NPY_MAGIC, NPY_MAGIC_LEN);
+    header[6] = 1;
+    header[7] = 0;
+    header[8] = dict_size & 0xFF;
+    header[9] = dict_size >> 8;
+    memcpy(header + NPY_PREAMBLE_LEN, dict, len);
+    memset(header + NPY_PREAMBLE_LEN + len, ' ', dict_size - len - 1);
+    header[header_size - 1] = '\n';
+
+    return header_size;
+}
+
+int write_binary_output(conv_config_t* restrict conv_conf, const void* restrict header, size_t header_size, double* restrict x, size_t sample_size)
+{
+    const size_t size = conv_conf->total_samples * conv_conf->channels;
+    int ret = 0;
+
+    FILE* file = fopen(conv_conf->ofile, "wb");
+    if(!(file)) {
+        fprintf(stderr, "\nError, unable to open output file.\n\n");
+
+        return 1;
+    }
+
+    if (header_size && fwrite(header, 1, header_size, file) != header_size) {
+        ret = 1;
+    } else if (sample_size == sizeof(double) && conv_conf->scale == 1.0) {
+        ret = fwrite(x, sizeof(double), size, file) != size;
+    } else {
+        /* Scale and convert a chunk at a time */
+        void* buf = malloc(SCALE_CHUNK_SAMPLES * sample_size);
+        ret = !buf;
+
+        for (size_t start = 0; start < size && !ret; start += SCALE_CHUNK_SAMPLES) {
+            const size_t count = size - start < SCALE_CHUNK_SAMPLES ? size - start : SCALE_CHUNK_SAMPLES;
+
+            if (sample_size == sizeof(float)) {
+                for (size_t i = 0; i < count; i++) {
+                    ((float*)buf)[i] = (float)(x[start + i] * conv_conf->scale);
+                }
+            } else {
+                for (size_t i = 0; i < count; i++) {
+                    ((double*)buf)[i] = x[start + i] * conv_conf->scale;
+                }
+            }
+            ret = fwrite(buf, sample_size, count, file) != count;
+        }
+
+        free(buf);
+    }
+
+    fclose(file);
+    if (ret) {
+        fprintf(stderr, "\nUnable to write the output to '%s'.\n", conv_conf->ofile);
+
+        return 1;
+    }
+
+    if (!conv_conf->quiet_flag) {
+        printf("Outputted data to '%s'.\n", conv_conf->ofile);
+    }
+    return 0;
+}
+
+void write_columns(FILE* restrict file, conv_config_t* restrict conv_conf, double* restrict x)
+{
+    if (conv_conf->columns) {
+        write_text(file, conv_conf, x, conv_conf->total_samples, 1, conv_conf->columns);
+
+        return;
+    }
+
+    write_frames(file, conv_conf, x, conv_conf->total_samples);
+}
+
+void write_frames(FILE* restrict file, conv_config_t* restrict conv_conf, double* restrict x, size_t frames)
+{
+    write_text(file, conv_conf, x, frames * conv_conf->channels, 1, conv_conf->channels);
+}
+
+void write_csv_rows(FILE* restrict file, conv_config_t* restrict conv_conf, double* restrict x)
+{
+    const uint8_t channels = conv_conf->channels;
+
+    if (conv_conf->columns) {
+        write_text(file, conv_conf, x, conv_conf->total_samples, 1, conv_conf->columns);
+
+        return;
+    }
+
+    for (uint8_t c = 0; c < channels; c++) {
+        write_text(file, conv_conf, x + c, conv_conf->total_samples, channels, conv_conf->total_samples);
+    }
+}
+
+void write_text(FILE* restrict file, conv_config_t* restrict conv_conf, double* restrict x, size_t count, size_t stride, size_t row)
+{
+    const uint16_t threads = conv_conf->threads ? conv_conf->threads : get_cpu_count();
+
+    /* Blocks of a stream and short outputs are not worth the threads */
+    if (threads > 1 && count > TEXT_CHUNK_SAMPLES && !write_text_parallel(file, conv_conf, x, count, stride, row, threads)) {
+        return;
+    }
+
+    write_text_range(file, x, 0, count, stride, row, conv_conf->precision, conv_conf->scale);
+}
+
+void write_text_range(FILE* restrict file, double* restrict x, size_t first, size_t count, size_t stride, size_t row, uint8_t precision, double scale)
+{
+    char buf[TEXT_BUFFER_SIZE];
+    size_t len = 0;
+
+    for (size_t i = first; i < first + count; i++) {
+        len += format_sample(buf + len, x[i * stride] * scale, precision);
+        buf[len++] = (i + 1) % row ? ',' : '\n';
+
+        /* Write the buffer out once another sample might not fit */
+        if (len > TEXT_BUFFER_SIZE - MAX_SAMPLE_CHARS - 1) {
+            fwrite(buf, 1, len, file);
+            len = 0;
+        }
+    }
+    fwrite(buf, 1, len, file);
+}
+
+int write_text_parallel(FILE* restrict file, conv_config_t* restrict conv_conf, double* restrict x, size_t count, size_t stride, size_t row, uint16_t threads)
+{
+    const size_t chunk_count = (count + TEXT_CHUNK_SAMPLES - 1) / TEXT_CHUNK_SAMPLES;
+    if (threads > chunk_count) {
+        threads = chunk_count;
+    }
+
+    text_chunk_t* chunks = calloc(threads, sizeof(text_chunk_t));
+    pthread_t* workers = malloc(threads * sizeof(pthread_t));
+    if (!chunks || !workers) {
+        free(chunks);
+        free(workers);
+
+        return 1;
+    }
+
+    /* Each round formats one chunk per thread, so memory stays bounded by the threads and not the output */
+    for (size_t first = 0; first < count; first += threads * TEXT_CHUNK_SAMPLES) {
+        uint16_t used = 0;
+        for (; used < threads && first + used * TEXT_CHUNK_SAMPLES < count; used++) {
+            text_chunk_t* chunk = &chunks[used];
+            chunk->x = x;
+            chunk->first = first + used * TEXT_CHUNK_SAMPLES;
+            chunk->count = count - chunk->first < TEXT_CHUNK_SAMPLES ? count - chunk->first : TEXT_CHUNK_SAMPLES;
+            chunk->stride = stride;
+            chunk->row = row;
+            chunk->precision = conv_conf->precision;
+            chunk->scale = conv_conf->scale;
+        }
+
+        /* Format a chunk on the calling thread if its worker could not be started */
+        uint8_t started[used];
+        for (uint16_t t = 0; t < used; t++) {
+            started[t] = !pthread_create(&workers[t], NULL, &text_chunk_worker, &chunks[t]);
+            if (!started[t]) {
+                text_chunk_worker(&chunks[t]);
+            }
+        }
+
+        for (uint16_t t = 0; t < used; t++) {
+            if (started[t]) {
+                pthread_join(workers[t], NULL);
+            }
+
+            if (chunks[t].ret) {
+                write_text_range(file, x, chunks[t].first, chunks[t].count, stride, row, conv_conf->precision, conv_conf->scale);
+            } else {
+                fwrite(chunks[t].buf, 1, chunks[t].len, file);
+            }
+        }
+    }
+
+    for (uint16_t t = 0; t < threads; t++) {
+        free(chunks[t].buf);
+    }
+    free(chunks);
+    free(workers);
+    return 0;
+}
+
+void* text_chunk_worker(void* arg)
+{
+    text_chunk_t* chunk = arg;
+
+    chunk->len = 0;
+    chunk->ret = 0;
+
+    for (size_t i = chunk->first; i < chunk->first + chunk->count; i++) {
+        if (chunk->size - chunk->len < MAX_SAMPLE_CHARS + 1) {
+            const size_t size = chunk->size ? 2 * chunk->size : chunk->count * TEXT_SAMPLE_GUESS + MAX_SAMPLE_CHARS + 1;
+            char* buf = realloc(chunk->buf, size);
+            if (!buf) {
+                chunk->ret = 1;
+
+                return NULL;
+            }
+            chunk->buf = buf;
+            chunk->size = size;
+        }
+
+        chunk->len += format_sample(chunk->buf + chunk->len, chunk->x[i * chunk->stride] * chunk->scale, chunk->precision);
+        chunk->buf[chunk->len++] = (i + 1) % chunk->row ? ',' : '\n';
+    }
+
+    return NULL;
+}
+
 void check_timer_end_output(conv_config_t* conv_conf)
 {
     if (conv_conf->timer_flag && !conv_conf->quiet_flag) {
@@ -673,13 +5523,31 @@ int output_help()
     printf( "\n"
             "Convolution tool (conv) help page.\n\n"
             "Basic usage 'conv <Input audio file or CSV file or CSV string> <Input audio file or CSV file or CSV string> [options]. For list of options see below.\n\n"
-            "\t\t--info\t\t\t\t= Output to stdout some info about the input file.\n"
+            "Use '-' as x[n] to stream it from stdin through the block engine, with y[n] written to stdout block by block. Raw streams give raw samples of the same type, WAV streams give text rows.\n\n"
+            "\t\t--info\t\t\t\t= Output to stdout some info about the input files and the peak and RMS level of the output.\n"
             "\t-i,\t--input <File/String>\t\t= Accepts audio files and CSV files or strings. Make sure to separate string with commas, e.g. 1,0,0,1. Use the options below if you want to specify but DFTT implements auto-detection.\n"
+            "\t\t--h-list <File>\t\t\t= Text file with one h[n] input or file pattern per line. x[n] is convolved with every h[n]. Extra inputs and patterns such as 'irs/ir-*.wav' after x[n] are also added.\n"
+            "\t\t--x-list <File/Directory>\t= Text file with one x[n] input or file pattern per line, a file pattern, or a directory of inputs. Every x[n] is convolved with the single h[n] input on a pool of threads.\n"
+            "\t\t--mem-limit <MiB>\t\t= Memory ceiling for convolving two audio files that do not fit in memory. Both inputs are read in chunks and partial sums are kept in a spill file next to the output. With '--norm' the finished output waits for its peak in a second spill file of 32-bit floats.\n"
+            "\t\t--ir-schedule <File>\t\t= Text file with one '<seconds> <h[n] input>' pair per line, in time order. The block engine switches from h[n] to each scheduled input at its time, crossfading their outputs. Every h[n] is partitioned and transformed once, and each block of x[n] once for all of them.\n"
+            "\t\t--crossfade <Milliseconds>\t= Crossfade length of the '--ir-schedule' switches. Defaults to 50 ms, 0 switches at once.\n"
+            "\t\t--cache-dir <Directory>\t\t= Directory for the partitioned h[n] spectra of the block engine. Later runs with the same h[n] map the cached spectra instead of decoding and transforming it.\n"
+            "\t\t--raw-dtype <Type>\t\t= Sample type of raw x[n] streamed from stdin with '-', and of '.raw', '.bin', and '.pcm' input files. Select between: 's16', 's24', 's32', 'f32', and 'f64'. Without it the stream is read as WAV.\n"
+            "\t\t--raw-channels <Number>\t\t= Channels of raw x[n] streamed from stdin and of raw input files. Defaults to 1.\n"
+            "\t-t,\t--threads <Number>\t\t= Worker threads for '--x-list', for parsing large CSV files, and for formatting long text outputs. Uses every CPU if not specified.\n"
             "\t-o,\t--output <File Name>\t\t= Path or name of the output file.\n"
-            "\t-f,\t--output-format <Format>\t= Format of the output file. Select between: 'audio', 'stdout', 'stdout-csv', 'columns', and 'csv'.\n"
-            "\t-p,\t--precision <Number>\t\t= Decimal number to define how many decimal places to output.\n"
-            "\t--norm,\t--normalise\t\t\t= Normalise the data. Only works wit --pow.\n"
-            "\t\t--timer\t\t\t\t= Start a timer to see how long the calculation takes.\n"
+            "\t-f,\t--output-format <Format>\t= Format of the output file. Select between: 'audio', 'stdout', 'stdout-csv', 'columns', 'csv', 'raw-f64', 'raw-f32', and 'npy'.\n"
+            "\t\t--out-subtype <Type>\t\t= Sample type of an audio output, instead of the one of the input. Select between: 'pcm16', 'pcm24', 'pcm32', 'float', and 'double'. Also sets the type of a raw stream written to stdout.\n"
+            "\t\t--out-container <Extension>\t= File format of an audio output, named by its extension such as 'wav', 'w64', 'rf64', 'aiff', 'caf', or 'flac'. Generated output names use the same extension.\n"
+            "\t-e,\t--engine <Engine>\t\t= Convolution engine. Select between: 'direct', 'direct-s16', 'fft', 'block', and 'separable'. Picked from the input sizes if not specified, with 'direct-s16' for short 16-bit PCM inputs and 'separable' for rank-1 2-D h[n].\n"
+            "\t\t--block-size <Number>\t\t= Block size of the block engine. Picked from the h[n] length if not specified.\n"
+            "\t-p,\t--precision <Number>\t\t= Decimal number to define how many decimal places to output. Use 'shortest' for the fewest digits that read back as the same value.\n"
+            "\t--norm,\t--normalise\t\t\t= Normalise the output to a peak of 1. The peak is tracked as the output is computed and the writers scale it as they write.\n"
+            "\t\t--norm-bound\t\t\t= Scale the output by a bound of its peak worked out from the inputs, so streams and long outputs are scaled as they are written. The headroom the bound costs is reported. A stream is taken to stay within full scale.\n"
+            "\t\t--complex\t\t\t= Read the inputs as complex I/Q signals, stereo audio or raw samples with I and Q as the two channels, or CSV with one I,Q pair per row. Mono inputs are real. The output has I and Q as its two channels. Runs on the 'direct' and 'fft' engines.\n"
+            "\t\t--2d\t\t\t\t= Read CSV inputs as matrices, one row per line, and convolve them in 2-D. The output is a matrix written a row per line. Runs on the 'direct', 'fft', and 'separable' engines.\n"
+            "\t\t--dither\t\t\t= Add triangular dither when quantizing an audio output to 16, 24, or 32-bit PCM. Samples clipped by the quantizer are counted and reported.\n"
+            "\t\t--timer\t\t\t\t= Start a timer to see how long the calculation takes, and how long each input took to read. The block engine pipeline reports the throughput of every stage.\n"
             "\t-q,\t--quiet\t\t\t\t= Silence all status messages to stdout. Overwrites '--info'.\n"
             "\n"
             );
@@ -5,6 +5,21 @@
 #include <math.h>
 #include <string.h>
 #include <time.h>
+#include <complex.h>
+#include <float.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <io.h>
+#include <fcntl.h>
+#else
+#include <glob.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#endif
 
 #define MAX_STR 500
 #define MIN_STR 200
@@ -15,10 +30,57 @@
 #define AUDIO_TYPE_CHAR 'a'
 #define CSV_TYPE_CHAR   'c'
 #define STR_TYPE_CHAR   's'
+#define STDIN_TYPE_CHAR '-'
+#define RAW_TYPE_CHAR   'r'
+#define NPY_TYPE_CHAR   'n'
+#define STDIN_NAME "-"
 #define WELCOME_STR "\nConvolution tool (conv). Created by Yiannis Michael (ymich9963), 2025.\n\nUse '--version' for version information, or '--help' for the list of options.\n\nBasic usage 'Conv <Input audio file or CSV file or CSV string> [options]. For list of options use '--help'.\n"
 #define VERSION_STR "\nconv v0.1.0.\n\n"
 #define SND_MAJOR_FORMAT_NUM 27
 #define SND_SUBTYPE_NUM 36
+#define DIRECT_MAX_SAMPLES 64   // Largest shorter input for which the direct sum is picked automatically
+#define PCM16_PRODUCT_SCALE 0x1p-30 // Value of one step of a product of two 16-bit PCM samples
+#define SEPARABLE_TOLERANCE 1e-12   // Largest error of a rank-1 factorisation of a 2-D h[n], relative to its peak
+#define SEPARABLE_STEPS 2.0     // Largest error of a rank-1 factorisation of a 2-D h[n] written to fewer decimals, in steps of its last decimal
+#define SEPARABLE_MAX_STEP 1e-3 // Coarsest last decimal of a 2-D h[n], relative to its peak, that its rank-1 test allows rounding for
+#define NO_CHANNEL -1
+#define BLOCK_MIN_SIZE 64       // Smallest automatic block size of the block engine
+#define BLOCK_MAX_SIZE 16384    // Largest automatic block size of the block engine
+#define SCHEDULE_CROSSFADE_MS 50    // Default crossfade length of the h[n] schedule
+#define IR_CACHE_MAGIC "CONVIRS1"
+#define IR_CACHE_EXT ".irs"
+#define FNV_OFFSET_BASIS 0xcbf29ce484222325ULL
+#define FNV_PRIME 0x100000001b3ULL
+#define RAW_SAMPLERATE 48000    // Sample rate given to raw streams when h[n] has none
+#define SPILL_EXT ".spill"
+#define NORM_SPILL_EXT ".norm.spill"
+#define PIPELINE_SLOTS 8        // Blocks each ring buffer of the block pipeline holds
+#define PIPELINE_STAGES 3
+#define READ_STAGE 0
+#define COMPUTE_STAGE 1
+#define WRITE_STAGE 2
+#define SHORTEST_PRECISION UINT8_MAX    // Precision value selecting the shortest text that reads back as the same double
+#define SHORTEST_STR "shortest"
+#define TEXT_BUFFER_SIZE 65536  // Bytes of formatted text gathered before each write
+#define MAX_SAMPLE_CHARS 576    // Longest formatted sample, a 309 digit double with 255 decimals and a sign
+#define TEXT_CHUNK_SAMPLES 262144    // Samples each thread formats at a time for text output
+#define TEXT_SAMPLE_GUESS 16    // Characters a text chunk starts with for each sample, it grows when they do not fit
+#define SCALE_CHUNK_SAMPLES 65536   // Samples the binary and audio writers scale or convert at a time
+#define DITHER_SEED 0x9E3779B97F4A7C15ULL   // Dither generator seed, fixed so outputs are repeatable
+#define ROUND_MAGIC 6755399441055744.0      // 1.5 * 2^52, adding and subtracting it rounds to the nearest integer
+#define MAX_EXACT_POW10 22      // Largest power of ten that is exact in a double
+#define MAX_EXACT_MANTISSA 9007199254740992ULL  // 2^53, larger integers are not all exact in a double
+#define MAX_TOKEN_CHARS 64      // Longest CSV value handed to strtod()
+#define CSV_MIN_CAPACITY 1024   // Samples a parsed CSV buffer starts with
+#define CSV_CHUNK_MIN_BYTES 1048576     // Smallest piece of CSV text given its own thread
+#define FAST_MAX_SCALED 1e15    // Largest scaled sample the fixed formatter rounds itself
+#define NPY_EXT ".npy"
+#define NPY_MAGIC "\x93NUMPY"
+#define NPY_MAGIC_LEN 6
+#define NPY_PREAMBLE_LEN 10     // Magic, version, and header length
+#define NPY_ALIGN 64            // The array data starts on a multiple of this
+#define NPY_MAX_HEADER 128
+#define OOC_MIN_FFT_SIZE 64     // Smallest chunk transform the memory limit may leave for the out-of-core engine
 
 /* Check macros */
 /* Check response from sscanf */
@@ -53,8 +115,8 @@
 						} \
 					  })
 
-#define	CHECK_INPUT_COUNT_MAXMIN(x) ({ if ((x) > MAXMIN_INPUT_COUNT) { \
-							fprintf(stderr, "A maximum and minimum of %d inputs are needed.\n", MAXMIN_INPUT_COUNT); \
+#define	CHECK_INPUT_COUNT_MIN(x) ({ if ((x) < MAXMIN_INPUT_COUNT) { \
+							fprintf(stderr, "At least %d inputs are needed.\n", MAXMIN_INPUT_COUNT); \
 							return 1; \
 						} \
 					  })
@@ -63,26 +125,145 @@ typedef struct Conv_Config conv_config_t;
 
 typedef struct InputInfo input_info_t;
 
+typedef struct FFTPlan fft_plan_t;
+
+typedef struct Spectra spectra_t;
+
+typedef struct MappedFile mapped_file_t;
+
+typedef struct Samples samples_t;
+
+typedef struct OutputStats output_stats_t;
+
+typedef struct PartitionedIR partitioned_ir_t;
+
+typedef struct IRCacheHeader ir_cache_header_t;
+
+typedef struct BlockConv block_conv_t;
+
+typedef struct BatchContext batch_context_t;
+
+typedef struct OutOfCore out_of_core_t;
+
+typedef struct InputReader input_reader_t;
+
+typedef struct TextChunk text_chunk_t;
+
+typedef struct CSVChunk csv_chunk_t;
+
+typedef struct BlockRing block_ring_t;
+
+typedef struct Pipeline pipeline_t;
+
+typedef struct Quantizer quantizer_t;
+
+typedef struct IRSchedule ir_schedule_t;
+
+/* Read only file mapping */
+typedef struct MappedFile {
+    void* data;
+    size_t size;
+#ifdef _WIN32
+    HANDLE file;
+    HANDLE mapping;
+#endif
+} mapped_file_t;
+
+/* Interleaved input samples, either decoded doubles or the native samples of a mapped file */
+typedef struct Samples {
+    const void* data;
+    int format;             // libsndfile subtype of the samples, SF_FORMAT_DOUBLE for decoded buffers
+} samples_t;
+
+/* Level of y[n], tracked by the engines as they write it */
+typedef struct OutputStats {
+    double peak;            // Largest absolute sample
+    double energy;          // Sum of the squared samples
+} output_stats_t;
+
 typedef struct InputInfo {
     char input_type;
     char ibuff[MAX_STR];
     size_t data_samples; 
     uint8_t channels;
 
+    /* Zero-copy input, the kernels convert the native samples as they read them */
+    mapped_file_t map;
+    samples_t samples;      // Samples in the mapping, data is NULL when the input was decoded to double
+    int16_t* pcm16;         // 16-bit PCM decoded with sf_readf_short when the file could not be mapped, held in samples
+
+    /* CSV parse throughput */
+    size_t text_bytes;
+    double text_seconds;
+    uint16_t threads;       // Threads to parse CSV text with, 0 for every CPU
+    uint8_t complex_flag;   // CSV values are I,Q pairs
+    uint8_t matrix_flag;    // CSV lines are the rows of a matrix
+    size_t rows;            // Rows of a matrix input
+
+    /* Probe results, handed to the reader so every input is opened or parsed once */
+    SNDFILE* probe_file;    // Audio file opened by get_input_type()
+    SF_INFO probe_info;
+    double* probe_data;     // Values of a CSV string parsed by get_input_type()
+
     int (*inp)(input_info_t* input_data, SF_INFO* sf_info, double** x);
 }input_info_t;
 
+/* h[n] inputs the block engine switches to at given times, crossfading from the output of one to the next */
+typedef struct IRSchedule {
+    size_t count;               // Scheduled h[n] inputs, switched to in order after the first h[n]
+    double* times;              // Seconds into y[n] each crossfade starts at
+    input_info_t* inputs;
+    size_t* starts;             // Frame each crossfade starts at
+    partitioned_ir_t** irs;     // Scheduled h[n] partitioned once, with the block size of the first h[n]
+    size_t fade;                // Crossfade length in frames
+    size_t size_h;              // Longest scheduled h[n]
+    uint8_t channels;           // Most channels of a scheduled h[n]
+} ir_schedule_t;
+
 typedef struct Conv_Config {
     /* Buffers */
     char ofile[MAX_STR];
 
     input_info_t input_info[MAXMIN_INPUT_COUNT];
     size_t total_samples; 
+    size_t columns;         // Columns of a 2-D output stored row by row, 0 for signals
+
+    /* Batch inputs, each one takes the place of input_info[batch_index] in turn */
+    input_info_t* batch_info;
+    size_t batch_count;
+    uint8_t batch_index;
     uint8_t channels;
 
-    /* Format specifier vars */
-    char format[9];         // Format string for the output precision
-    uint8_t precision;
+    /* Engine settings */
+    size_t block_size;      // Block size of the block engine, 0 picks it from h[n]
+    uint16_t threads;       // Batch worker threads, 0 uses every CPU
+    size_t mem_limit;       // Memory ceiling in bytes of the out-of-core engine, 0 keeps the inputs in memory
+
+    /* Time varying h[n] of the block engine */
+    ir_schedule_t schedule;
+    double crossfade;       // Crossfade length of the schedule in seconds, negative until given
+
+    /* IR spectrum cache */
+    char cache_dir[MAX_STR];
+    partitioned_ir_t* ir;   // Partitioned h[n] loaded from the cache, or made when it was stored
+    spectra_t* spectra_h;   // h[n] spectra made while x[n] was still being read
+
+    /* Raw sample layout, used when x[n] is streamed without a header */
+    int raw_format;         // libsndfile subtype of the raw samples, 0 when the stream is WAV
+    uint8_t raw_channels;
+
+    /* Audio output format, 0 keeps the one of the input */
+    int out_subtype;            // libsndfile subtype
+    int out_container;          // libsndfile major format
+    const char* out_extension;  // Extension of the container from libsndfile, names the generated outputs
+
+    /* Text output */
+    uint8_t precision;      // Decimal places, or SHORTEST_PRECISION
+
+    /* Output level */
+    output_stats_t stats;   // Level of the y[n] written by the last engine call
+    double scale;           // Applied by the output writers as they convert y[n], 1 unless normalised
+    double norm_bound;      // Bound of the output peak worked out from the inputs with '--norm-bound'
 
     /* Timers */
     struct timespec start_time;
@@ -94,11 +275,183 @@ typedef struct Conv_Config {
     uint8_t quiet_flag;
     uint8_t timer_flag;
     uint8_t norm_flag;
+    uint8_t norm_bound_flag;
+    uint8_t dither_flag;
+    uint8_t complex_flag;   // Two channel inputs are I/Q signals, convolved as one complex channel
+    uint8_t matrix_flag;    // CSV inputs are matrices, convolved in 2-D
+    uint8_t stream_flag;
 
     /* Function pointers */
     int (*outp)(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+    int (*conv_fcn)(conv_config_t* conv_conf, double* x, double* h, double* y);
 } conv_config_t;
 
+typedef struct FFTPlan {
+    size_t N;                   // Transform size, always a power of two
+    double complex* twiddles;   // First N/2 forward twiddle factors
+    size_t* rev;                // Bit reversed index of every sample
+} fft_plan_t;
+
+/* Channel pair spectra. Each pair of real channels shares one complex FFT, with the first channel in the real part and the second in the imaginary part. */
+typedef struct Spectra {
+    size_t N;                   // Transform size of every spectrum
+    uint8_t pairs;              // Number of packed channel pairs
+    uint8_t channels;           // Output channels the pairs were laid out for
+    uint8_t* shared;            // Pair holds a single real channel that applies to both of its output channels
+    double complex** bins;      // One N point spectrum per pair
+} spectra_t;
+
+/* h[n] split into uniform partitions of block_size samples, each stored as the half spectrum (N/2 + 1 bins) of a 2*block_size point FFT */
+typedef struct PartitionedIR {
+    size_t block_size;          // Samples per partition, half the FFT size
+    size_t partitions;          // Number of partitions
+    uint8_t channels;           // h[n] channels
+    double complex* bins;       // partitions * channels half spectra
+    mapped_file_t map;          // Cache file the bins point into, if any
+} partitioned_ir_t;
+
+/* Cache file header, followed by the partition spectra in the order of partitioned_ir_t.bins */
+typedef struct IRCacheHeader {
+    char magic[8];              // IR_CACHE_MAGIC
+    uint64_t hash;              // Content hash of the h[n] input
+    uint64_t requested_size;    // Requested block size, 0 when picked from h[n]
+    uint64_t block_size;
+    uint64_t partitions;
+    uint64_t size_h;            // h[n] frames
+    int32_t samplerate;
+    int32_t format;
+    uint8_t channels;
+    char input_type;
+    uint8_t reserved[6];        // Keeps the spectra 16 byte aligned
+} ir_cache_header_t;
+
+/* Uniformly partitioned overlap-save state for one x[n] against a partitioned h[n] */
+typedef struct BlockConv {
+    partitioned_ir_t* ir;       // Shared and read only
+    fft_plan_t* plan;           // Shared and read only
+    ir_schedule_t* schedule;    // Shared and read only, NULL when ir is used for all of y[n]
+    uint8_t channels_x;         // x[n] channels
+    uint8_t channels;           // Output channels
+    size_t slots;               // Blocks of x[n] in the delay line, the most partitions of any h[n]
+    size_t fdl_pos;             // Slot of the newest block in the frequency domain delay line
+    size_t position;            // Frames of y[n] output so far
+    double complex* fdl;        // slots * channels_x half spectra of past x[n] blocks
+    double* weights;            // Gain of every h[n] of the schedule over one block
+    double* history;            // Previous block of x[n], interleaved
+    double complex* Z;          // Transform buffer
+    double complex* acc;        // Half spectrum accumulators of one output channel pair
+} block_conv_t;
+
+/* Shared state of the batch worker threads */
+typedef struct BatchContext {
+    conv_config_t* conv_conf;
+    SF_INFO* sf_info_h;
+    partitioned_ir_t* ir;
+    fft_plan_t* plan;
+    pthread_mutex_t lock;
+    size_t next;                // Next batch input to claim
+    size_t done;                // Batch inputs written
+    size_t samples;             // x[n] samples convolved
+} batch_context_t;
+
+/* Bounded ring of blocks between two pipeline stages. Slots are filled and drained in place */
+typedef struct BlockRing {
+    double* blocks;             // slots blocks of block_samples doubles
+    size_t* frames;             // Frames in each filled slot, fewer than a block marks the end
+    size_t slots;
+    size_t block_samples;
+    size_t head;                // Oldest filled slot
+    size_t count;               // Filled slots
+    uint8_t abort_flag;         // A stage failed, every wait returns NULL
+    pthread_mutex_t lock;
+    pthread_cond_t filled;
+    pthread_cond_t drained;
+} block_ring_t;
+
+/* Reader, compute, and writer stages of the block engine */
+typedef struct Pipeline {
+    conv_config_t* conv_conf;
+    block_conv_t* bc;
+    SNDFILE* file_x;
+    SNDFILE* file_y;            // NULL writes text rows to stdout
+    quantizer_t* quantizer;     // Converter of the blocks written to file_y
+    uint8_t flush_flag;         // Flush every block, for pipes
+    block_ring_t* x_ring;
+    block_ring_t* y_ring;
+    size_t frames[PIPELINE_STAGES];     // Frames each stage handled
+    double seconds[PIPELINE_STAGES];    // Time each stage spent working, without the waits on its rings
+    int ret[PIPELINE_STAGES];
+} pipeline_t;
+
+/* Converter of y[n] to the native samples of an audio output */
+typedef struct Quantizer {
+    int format;                 // libsndfile subtype written, fixed-point ones are quantized here and others are written as doubles
+    double gain;                // Full scale of the fixed-point samples, the largest positive sample
+    double min;
+    double max;
+    int32_t step;               // Integer step of one sample, 24-bit samples go to libsndfile in the top bits of an int
+    uint64_t seed;              // Dither generator state
+    size_t clipped;             // Samples more than a step beyond full scale, so a normalised and dithered peak is limited without counting
+    void* buf;                  // SCALE_CHUNK_SAMPLES converted samples
+    double* noise;              // SCALE_CHUNK_SAMPLES of dither in steps, all zero without dithering
+} quantizer_t;
+
+/* Part of the text output formatted by one thread */
+typedef struct TextChunk {
+    double* x;
+    size_t first;           // Index of the first sample, which also places its separator
+    size_t count;
+    size_t stride;
+    size_t row;
+    uint8_t precision;
+    double scale;
+    char* buf;              // Formatted text, kept between chunks
+    size_t len;
+    size_t size;
+    int ret;                // The buffer could not grow, the chunk is formatted again while writing
+} text_chunk_t;
+
+/* Piece of CSV text parsed by one thread */
+typedef struct CSVChunk {
+    const char* data;       // Starts and ends on separators, so no value is split
+    size_t size;
+    const char* name;
+    double* x;              // Values of this chunk, copied into place once every chunk is done
+    size_t samples;
+    int ret;
+} csv_chunk_t;
+
+/* One input read on its own thread */
+typedef struct InputReader {
+    input_info_t* input_info;
+    SF_INFO* sf_info;
+    double** x;
+    double seconds;             // Time taken to read the input
+    int ret;
+} input_reader_t;
+
+/* Out-of-core engine state, every buffer is sized from the memory limit */
+typedef struct OutOfCore {
+    SNDFILE* file_x;
+    SNDFILE* file_h;
+    FILE* spill;                // Partial sums of y[n], frame n is kept at n % spill_window
+    FILE* norm_spill;           // Completed frames waiting for the peak when normalising, or NULL
+    SNDFILE* file_y;
+    fft_plan_t* plan;
+    size_t chunk_x;             // x[n] frames per chunk
+    size_t chunk_h;             // h[n] frames per chunk
+    size_t spill_window;        // Frames the spill file holds, enough for every frame still being added to
+    size_t spill_frames;        // Frames added to so far, the rest have no partial sums yet
+    size_t norm_bytes;          // Bytes per sample in the normalisation spill, a float unless the output needs more
+    size_t final_frames;        // Frames no later chunk pair adds to, already counted in the output level
+    double* x;
+    double* h;
+    double* y;                  // Convolution of one chunk pair, then the conversion buffer of the completed frames
+    double* acc;                // Spill file frames being accumulated into
+    double complex* Y;
+    quantizer_t* quantizer;
+} out_of_core_t;
+
 /**
  * @brief Set default values to make sure Conv runs correctly.
  *
@@ -116,212 +469,1853 @@ void set_defaults(conv_config_t* conv_conf);
  */
 int get_options(int argc, char** argv, conv_config_t* conv_conf);
 
+/**
+ * @brief Add an input from the CLI. The first input is x[n] and every following input is an h[n].
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ibuff Input file, string, or file pattern.
+ * @param input_count Inputs added so far.
+ * @return Success or failure.
+ */
+int add_input(conv_config_t* conv_conf, char* ibuff, int* input_count);
+
+/**
+ * @brief Add an input to the batch, expanding it first if it is a file pattern.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ibuff Input file, string, or file pattern.
+ * @param index Input the batch replaces, X_INDEX or H_INDEX.
+ * @return Success or failure.
+ */
+int add_batch_inputs(conv_config_t* conv_conf, char* ibuff, uint8_t index);
+
+/**
+ * @brief Append a single input to the batch and detect its type.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ibuff Input file or string.
+ * @param index Input the batch replaces, X_INDEX or H_INDEX.
+ * @return Success or failure.
+ */
+int append_batch_input(conv_config_t* conv_conf, char* ibuff, uint8_t index);
+
+/**
+ * @brief Expand a file pattern such as 'ir-*.wav' and add every match to the batch.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param pattern File pattern.
+ * @param index Input the batch replaces, X_INDEX or H_INDEX.
+ * @param skip_flag Skip matches that are not inputs instead of failing.
+ * @return Success or failure.
+ */
+int expand_input_pattern(conv_config_t* conv_conf, char* pattern, uint8_t index, uint8_t skip_flag);
+
+/**
+ * @brief Read a list file with one input or file pattern per line and add them to the batch. A directory adds every input inside it and a file pattern adds every match.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param list_file List file or directory name.
+ * @param index Input the batch replaces, X_INDEX or H_INDEX.
+ * @return Success or failure.
+ */
+int read_input_list(conv_config_t* conv_conf, char* list_file, uint8_t index);
+
+/**
+ * @brief Check the inputs once all the options are read. A batch of one becomes a normal input, and with a batch of x[n] inputs the single input given is h[n].
+ *
+ * @param conv_conf Conv Config struct.
+ * @return Success or failure.
+ */
+int check_inputs(conv_config_t* conv_conf);
+
 int get_input_type(input_info_t* input_info);
 
 /**
- * @brief Check if the timer should be started.
+ * @brief Read x[n] on its own thread while h[n] is read and transformed for the engine, so the decode of one input overlaps the other.
  *
  * @param conv_conf Conv Config struct.
+ * @param sf_info_x x[n] SF_INFO struct.
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @param x Pointer to the x[n] data buffer.
+ * @param h Pointer to the h[n] data buffer.
+ * @return Success or failure.
  */
-void check_timer_start(conv_config_t* conv_conf);
+int read_inputs(conv_config_t* conv_conf, SF_INFO* sf_info_x, SF_INFO* sf_info_h, double** x, double** h);
 
-void conv(double* x1, size_t size_x1, double* x2, size_t size_x2, double* y, size_t size_y);
+/**
+ * @brief Input reader thread.
+ *
+ * @param arg Input reader.
+ * @return NULL.
+ */
+void* input_reader_worker(void* arg);
 
 /**
- * @brief Get a date and time string in HHMMSSddmmyy format.
+ * @brief Pick the engine from the probed sizes and transform h[n] for it, partitions for the block engine and channel spectra for the FFT engine.
  *
- * @return Date/time string.
+ * @param conv_conf Conv Config struct.
+ * @param h Interleaved h[n] data.
+ * @param size_x Probed x[n] frames.
+ * @param channels_x Probed x[n] channels.
  */
-char* get_datetime_string();
+void prepare_h(conv_config_t* conv_conf, double* h, size_t size_x, uint8_t channels_x);
 
 /**
- * @brief Get the extension from the input file name.
+ * @brief Get the seconds passed since a time.
  *
- * @param ifile_name Input file name to the function. 
- * @return Blank string or extension.
+ * @param start Start time.
+ * @return Seconds.
  */
-char* get_extension(char* ifile_name);
+double get_seconds_since(struct timespec* start);
 
 /**
- * @brief Generate the output file name based on the input flag and the input file name.
+ * @brief Check if the timer should be started.
  *
- * @param ofile Output file name.
- * @param ifile Input file name.
- * @param input_flag Input flag to distinguish between CSV file and string.
+ * @param conv_conf Conv Config struct.
  */
-void generate_file_name(char* ofile, input_info_t* input_info, uint8_t input_flag);
+void check_timer_start(conv_config_t* conv_conf);
+
+void conv(double* x1, size_t size_x1, double* x2, size_t size_x2, double* y, size_t size_y, output_stats_t* stats);
 
 /**
- * @brief Select the output format.
+ * @brief Direct convolution sum of one channel of 16-bit PCM samples. Products are summed exactly in 64-bit integers and scaled to double once per output sample.
+ *
+ * @param x x[n] samples.
+ * @param size_x Samples in x[n].
+ * @param h_rev h[n] samples in reverse order.
+ * @param size_h Samples in h[n].
+ * @param y Output, written every stride samples.
+ * @param stride Distance between output samples, the channel count of interleaved outputs.
+ * @param size_y Samples in the output.
+ * @param stats Output level to update.
+ */
+void conv_s16(const int16_t* x, size_t size_x, const int16_t* h_rev, size_t size_h, double* y, uint8_t stride, size_t size_y, output_stats_t* stats);
+
+/**
+ * @brief Copy one channel out of interleaved 16-bit PCM samples, at any alignment.
+ *
+ * @param x Interleaved samples.
+ * @param frames Frames in the buffer.
+ * @param channels Channels in the buffer.
+ * @param channel Channel to copy.
+ * @param reverse_flag Copy the channel in reverse order.
+ * @param x_ch Destination buffer of size frames.
+ */
+void get_channel_s16(const void* x, size_t frames, uint8_t channels, uint8_t channel, uint8_t reverse_flag, int16_t* x_ch);
+
+/**
+ * @brief Select the convolution engine.
  *
  * @param conv_conf Conv Config struct.
  * @param strval Option value.
  * @return Success or failure.
  */
-int select_output_format(conv_config_t* conv_conf, char* strval);
+int select_engine(conv_config_t* conv_conf, char* strval);
 
-int read_audio_file_input(input_info_t* conv_conf, SF_INFO* sf_info, double** x);
+/**
+ * @brief Pick the engine based on the input sizes. The direct sum is used when one of the inputs is short, in integers when both are 16-bit PCM, and the block engine when the spectrum cache is used.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param size_x Samples in x[n].
+ * @param size_h Samples in h[n].
+ * @return Engine function pointer.
+ */
+int (*autoset_engine(conv_config_t* conv_conf, size_t size_x, size_t size_h)) (conv_config_t*, double*, double*, double*);
 
 /**
- * @brief Open the audio file.
+ * @brief Copy one channel out of interleaved samples.
  *
- * @param file Pointer to SNDFILE pointer.
- * @param sf_info SF_INFO type from libsndfile.
- * @param ibuff Input buffer of size MAX_STR 
- * @return Success or failure.
+ * @param x Interleaved samples.
+ * @param frames Frames in the buffer.
+ * @param channels Channels in the buffer.
+ * @param channel Channel to copy.
+ * @param x_ch Destination buffer of size frames.
  */
-int open_audio_file(SNDFILE** file, SF_INFO* sf_info, char* ibuff);
+void get_channel(samples_t x, size_t frames, uint8_t channels, uint8_t channel, double* x_ch);
 
 /**
- * @brief Get the data from the audio file.
+ * @brief Read one sample, converting native samples to double the same way libsndfile does.
  *
- * @param file SNDFILE pointer.
- * @param sf_info SF_INFO type from libsndfile.
- * @param x Pointer to data buffer.
- * @return Success or failure.
+ * @param x Interleaved samples.
+ * @param index Sample index.
+ * @return Sample value.
  */
-int get_audio_file_data(SNDFILE* file, SF_INFO* sf_info, double** x);
+static inline double get_sample(samples_t x, size_t index)
+{
+    int16_t s16;
+    int32_t s32;
+    const unsigned char* s24;
+    float f32;
+    double f64;
 
+    /* memcpy keeps the loads legal for data chunks at any alignment */
+    switch (x.format) {
+        case SF_FORMAT_PCM_16:
+            memcpy(&s16, (const char*)x.data + index * sizeof(int16_t), sizeof(int16_t));
+            return s16 / 32768.0;
+        case SF_FORMAT_PCM_24:
+            s24 = (const unsigned char*)x.data + index * 3;
+            return (int32_t)((uint32_t)s24[0] << 8 | (uint32_t)s24[1] << 16 | (uint32_t)s24[2] << 24) / 2147483648.0;
+        case SF_FORMAT_PCM_32:
+            memcpy(&s32, (const char*)x.data + index * sizeof(int32_t), sizeof(int32_t));
+            return s32 / 2147483648.0;
+        case SF_FORMAT_FLOAT:
+            memcpy(&f32, (const char*)x.data + index * sizeof(float), sizeof(float));
+            return f32;
+        default:
+            memcpy(&f64, (const char*)x.data + index * sizeof(double), sizeof(double));
+            return f64;
+    }
+}
 
 /**
- * @brief Get the SNDFILE major format string. Same as descriptions given in the documentation.
+ * @brief Add an output sample to the output level.
  *
- * @param sf_info Pointer to SF_INFO variable containing file information.
- * @return Major format string
+ * @param stats Output level.
+ * @param y Output sample.
  */
-const char* get_sndfile_major_format(SF_INFO* sf_info);
+static inline void track_sample(output_stats_t* stats, double y)
+{
+    const double abs_y = fabs(y);
+
+    stats->peak = abs_y > stats->peak ? abs_y : stats->peak;
+    stats->energy += y * y;
+}
 
 /**
- * @brief Get the SNDFILE subtype string. Same as subtypes given in the documentation.
+ * @brief Add a buffer of output samples to the output level.
  *
- * @param sf_info Pointer to SF_INFO variable containing file information.
- * @return Subtype string.
+ * @param stats Output level.
+ * @param y Output samples.
+ * @param count Number of samples.
  */
-const char* get_sndfile_subtype(SF_INFO* sf_info);
+static inline void track_samples(output_stats_t* stats, const double* y, size_t count)
+{
+    for (size_t n = 0; n < count; n++) {
+        track_sample(stats, y[n]);
+    }
+}
 
 /**
- * @brief Check the string if is in CSV format.
+ * @brief View a decoded buffer as samples.
  *
- * @param ibuff Input buffer.
- * @return Success or failure.
+ * @param x Interleaved double buffer.
+ * @return Samples.
  */
-int check_csv_string(char* ibuff);
+samples_t double_samples(double* x);
 
 /**
- * @brief Check the extension in the input buffer if it can be read like a CSV.
+ * @brief Check if an input holds native 16-bit PCM samples.
  *
- * @param ibuff Input buffer.
+ * @param input_info Input info struct.
+ * @return 1 for 16-bit PCM samples, 0 otherwise.
+ */
+uint8_t check_s16_input(input_info_t* input_info);
+
+/**
+ * @brief Get the samples of an input, from its mapping or native 16-bit PCM when it has them and from the decoded buffer otherwise.
+ *
+ * @param input_info Input info struct.
+ * @param x Decoded buffer, NULL for mapped inputs.
+ * @return Samples.
+ */
+samples_t get_input_samples(input_info_t* input_info, double* x);
+
+/**
+ * @brief Skip a number of samples.
+ *
+ * @param x Interleaved samples.
+ * @param count Samples to skip.
+ * @return Samples starting count samples later.
+ */
+samples_t offset_samples(samples_t x, size_t count);
+
+/**
+ * @brief Get the size of one native sample.
+ *
+ * @param format libsndfile subtype.
+ * @return Size in bytes, 0 if the kernels can not read it natively.
+ */
+size_t get_sample_bytes(int format);
+
+/**
+ * @brief Copy one channel into an interleaved buffer.
+ *
+ * @param y Interleaved buffer.
+ * @param frames Frames in the buffer.
+ * @param channels Channels in the buffer.
+ * @param channel Channel to write.
+ * @param y_ch Source buffer of size frames.
+ */
+void set_channel(double* y, size_t frames, uint8_t channels, uint8_t channel, double* y_ch);
+
+/**
+ * @brief Direct convolution sum engine. Each output channel is convolved separately with conv().
+ *
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved x[n] data.
+ * @param h Interleaved h[n] data.
+ * @param y Interleaved output buffer.
  * @return Success or failure.
  */
-int check_csv_extension(char* ibuff);
+int conv_direct(conv_config_t* conv_conf, double* x, double* h, double* y);
 
 /**
- * @brief Read the input as a CSV file or CSV string.
+ * @brief Direct convolution sum engine for 16-bit PCM inputs. The native samples are convolved in integers with conv_s16(), and other inputs fall back to conv_direct().
  *
  * @param conv_conf Conv Config struct.
- * @param x Pointer to data buffer.
+ * @param x Interleaved x[n] data, NULL when the input holds native samples.
+ * @param h Interleaved h[n] data, NULL when the input holds native samples.
+ * @param y Interleaved output buffer.
  * @return Success or failure.
  */
-int read_csv_string_file_input(input_info_t* input_data, SF_INFO* sf_info, double** x);
+int conv_direct_s16(conv_config_t* conv_conf, double* x, double* h, double* y);
 
 /**
- * @brief Open the input file as a CSV file. If the function fails it means it's a CSV string.
+ * @brief FFT convolution engine. Channel pairs share one complex transform, and mono inputs pack x[n] and h[n] into a single transform.
  *
- * @param file Pointer to FILE pointer.
- * @param ibuff Input buffer.
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved x[n] data.
+ * @param h Interleaved h[n] data.
+ * @param y Interleaved output buffer.
  * @return Success or failure.
  */
-int open_csv_file(FILE** file, char* ibuff);
+int conv_fft(conv_config_t* conv_conf, double* x, double* h, double* y);
 
 /**
- * @brief Read the data from the CSV file.
+ * @brief Direct convolution sum engine for complex I/Q inputs, run by conv_direct() with '--complex'.
  *
- * @param file FILE pointer.
- * @param data_string Pointer to a string buffer.
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved x[n] data, I/Q or real.
+ * @param h Interleaved h[n] data, I/Q or real.
+ * @param y Interleaved I/Q output buffer.
  * @return Success or failure.
  */
-int read_csv_file_data(FILE* file, char** data_string);
+int conv_direct_complex(conv_config_t* conv_conf, double* x, double* h, double* y);
 
 /**
- * @brief Get the data from a CSV string and store it in a buffer.
+ * @brief FFT convolution engine for complex I/Q inputs, run by conv_fft() with '--complex'. Each input is a single complex transform.
  *
- * @param data_string String containing the data.
- * @param x Pointer to buffer to store the data.
- * @param detected_samples Variable to store the detected samples in the string.
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved x[n] data, I/Q or real.
+ * @param h Interleaved h[n] data, I/Q or real.
+ * @param y Interleaved I/Q output buffer.
  * @return Success or failure.
  */
-int get_data_from_string(char* data_string, double** x, size_t* detected_samples);
+int conv_fft_complex(conv_config_t* conv_conf, double* x, double* h, double* y);
 
-void show_input_info(input_info_t* input_info, SF_INFO* sf_info);
+/**
+ * @brief Direct convolution sum of complex signals.
+ *
+ * @param x x[n] samples.
+ * @param size_x Samples in x[n].
+ * @param h h[n] samples.
+ * @param size_h Samples in h[n].
+ * @param y Output, with the layout of interleaved I/Q doubles.
+ * @param size_y Samples in the output.
+ * @param stats Output level to update with both parts.
+ */
+void conv_complex(const double complex* x, size_t size_x, const double complex* h, size_t size_h, double complex* y, size_t size_y, output_stats_t* stats);
 
 /**
- * @brief Set the precision to output values in.
+ * @brief Get an input as complex samples. Decoded I/Q doubles are used in place, other inputs are copied with a zero imaginary part for real ones.
  *
- * @param format Format string to be used in printf().
- * @param precision Precision amount.
+ * @param input_info Input info struct.
+ * @param x Decoded buffer, NULL for inputs with native samples.
+ * @param buf Set to the copy when one is made, to be freed by the caller.
+ * @return Complex samples, or NULL when the copy can not be allocated.
  */
-void set_precision_format(char format[9], uint8_t precision);
+const double complex* get_complex_input(input_info_t* input_info, double* x, double complex** buf);
 
-int (*autoset_output_format(char type_x, char type_h)) (conv_config_t*, SF_INFO*, double*);
+/**
+ * @brief Check both inputs are I/Q or real, and give the output its I and Q channels.
+ *
+ * @param conv_conf Conv Config struct.
+ * @return Success or failure.
+ */
+int check_complex_channels(conv_config_t* conv_conf);
 
 /**
- * @brief Check if the timer should be stopped and outputed.
+ * @brief Direct convolution sum engine for matrices, run by conv_direct() with '--2d'. Each x[n] value adds a scaled copy of h[n] to the output a row at a time.
  *
  * @param conv_conf Conv Config struct.
+ * @param x x[n] matrix, row by row.
+ * @param h h[n] matrix, row by row.
+ * @param y Output matrix, row by row.
+ * @return Success or failure.
  */
-void check_timer_end_output(conv_config_t* conv_conf);
+int conv_direct_2d(conv_config_t* conv_conf, double* x, double* h, double* y);
 
 /**
- * @brief Output result to stdout.
+ * @brief FFT convolution engine for matrices, run by conv_fft() with '--2d'. x[n] and h[n] are packed into one 2-D transform made of row and column FFTs.
  *
- * @param conv_conf WindFcn config struct.
- * @param sf_info Input file SF_INFO struct. Unused in this function.
- * @param x Data buffer.
+ * @param conv_conf Conv Config struct.
+ * @param x x[n] matrix, row by row.
+ * @param h h[n] matrix, row by row.
+ * @param y Output matrix, row by row.
  * @return Success or failure.
  */
-int output_stdout(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+int conv_fft_2d(conv_config_t* conv_conf, double* x, double* h, double* y);
 
 /**
- * @brief Output result to stdout as CSVs.
+ * @brief Separable convolution engine for matrices. A rank-1 h[n] is factored into a column and a row, and x[n] is convolved with them in two 1-D passes.
  *
- * @param conv_conf WindFcn config struct.
- * @param sf_info Input file SF_INFO struct. Unused in this function.
- * @param x Data buffer.
+ * @param conv_conf Conv Config struct.
+ * @param x x[n] matrix, row by row.
+ * @param h h[n] matrix, row by row, must be rank-1.
+ * @param y Output matrix, row by row.
  * @return Success or failure.
  */
-int output_stdout_csv(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+int conv_separable_2d(conv_config_t* conv_conf, double* x, double* h, double* y);
 
 /**
- * @brief Output result to a file as a column.
+ * @brief Factor a matrix into the outer product of a column and a row. The column and row through the largest value are taken, and the matrix is rank-1 if their product gives it back to within SEPARABLE_TOLERANCE.
  *
- * @param conv_conf WindFcn config struct.
- * @param sf_info Input file SF_INFO struct. Unused in this function.
- * @param x Data buffer.
+ * @param h Matrix, row by row.
+ * @param rows Rows of the matrix.
+ * @param columns Columns of the matrix.
+ * @param u Column factor of size rows.
+ * @param v Row factor of size columns.
+ * @param rounding_flag Also allow for the rounding of a matrix written with fewer decimals than a double holds. Whole numbers are taken as exact.
+ * @return 1 if the matrix is rank-1, 0 otherwise.
+ */
+uint8_t factor_separable(const double* h, size_t rows, size_t columns, double* u, double* v, uint8_t rounding_flag);
+
+/**
+ * @brief Get the last decimal place that values were written to, such as 1e-6 for values printed with 6 decimals.
+ *
+ * @param x Values.
+ * @param count Number of values.
+ * @return Step of the last decimal, or 0 if the values have more decimals than a double holds.
+ */
+double get_decimal_step(const double* x, size_t count);
+
+/**
+ * @brief Set the size of a 2-D output, and pick the engine when none is given. Rank-1 h[n] matrices run on the separable engine, the rest on the direct or FFT engine by size.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param h h[n] matrix, row by row.
  * @return Success or failure.
  */
-int output_file_columns(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+int set_matrix_output(conv_config_t* conv_conf, double* h);
 
 /**
- * @brief Output result to a CSV file.
+ * @brief Get the columns of a matrix input.
  *
- * @param conv_conf WindFcn config struct.
- * @param sf_info Input file SF_INFO struct. Unused in this function.
- * @param x Data buffer.
+ * @param input_info Input info struct.
+ * @return Columns.
+ */
+size_t get_matrix_columns(input_info_t* input_info);
+
+/**
+ * @brief FFT convolution against an already transformed x[n]. Only h[n] is transformed, unless it was already transformed while x[n] was read, followed by the multiply and inverse stages.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param plan FFT plan the x[n] spectra were made with.
+ * @param X Channel pair spectra of x[n] for conv_conf->channels output channels.
+ * @param h Interleaved h[n] data.
+ * @param y Interleaved output buffer.
  * @return Success or failure.
  */
-int output_file_csv(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+int conv_fft_transformed(conv_config_t* conv_conf, fft_plan_t* plan, spectra_t* X, double* h, double* y);
 
 /**
- * @brief Output result as an audio file.
+ * @brief Convolve x[n] with every h[n] in the batch. x[n] is transformed once and each h[n] only goes through the multiply and inverse stages.
  *
- * @param conv_conf WindFcn config struct.
- * @param sf_info Input file SF_INFO struct.
- * @param x Data buffer.
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_x x[n] SF_INFO struct.
+ * @param x Interleaved x[n] data.
  * @return Success or failure.
  */
-int output_file_audio(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+int conv_batch_h(conv_config_t* conv_conf, SF_INFO* sf_info_x, double* x);
+
+/**
+ * @brief Block engine. h[n] is split into uniform partitions and x[n] is convolved block by block with uniformly partitioned overlap-save.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved x[n] data.
+ * @param h Interleaved h[n] data.
+ * @param y Interleaved output buffer.
+ * @return Success or failure.
+ */
+int conv_block(conv_config_t* conv_conf, double* x, double* h, double* y);
+
+/**
+ * @brief Get the block size of the block engine. Picked from the h[n] length if not specified.
+ *
+ * @param block_size Requested block size or 0.
+ * @param size_h Samples in h[n].
+ * @return Power of two block size.
+ */
+size_t get_block_size(size_t block_size, size_t size_h);
+
+/**
+ * @brief Split h[n] into partitions of plan->N/2 samples and transform them. Pairs of h[n] channels share one FFT.
+ *
+ * @param plan FFT plan of twice the block size.
+ * @param h Interleaved h[n] samples.
+ * @param size_h Samples in h[n].
+ * @param channels h[n] channels.
+ * @return Partitioned h[n] or NULL.
+ */
+partitioned_ir_t* partition_ir(fft_plan_t* plan, samples_t h, size_t size_h, uint8_t channels);
+
+void destroy_partitioned_ir(partitioned_ir_t* ir);
+
+/**
+ * @brief Get the half spectrum of one partition and channel.
+ *
+ * @param ir Partitioned h[n].
+ * @param partition Partition index.
+ * @param channel h[n] channel.
+ * @return Half spectrum of block_size + 1 bins.
+ */
+double complex* get_partition(partitioned_ir_t* ir, size_t partition, uint8_t channel);
+
+/**
+ * @brief Separate the transform of two packed real channels into their half spectra.
+ *
+ * @param Z Transform of the packed pair.
+ * @param N Transform size.
+ * @param S0 Half spectrum of the real part channel.
+ * @param S1 Half spectrum of the imaginary part channel, or NULL when there is none.
+ */
+void split_packed_spectrum(double complex* Z, size_t N, double complex* S0, double complex* S1);
 
-void normalise_data(double* x, size_t size);
+/**
+ * @brief Pack two real channel half spectra into one full spectrum, so a single inverse FFT returns both channels.
+ *
+ * @param Z Full spectrum of size N.
+ * @param N Transform size.
+ * @param S0 Half spectrum of the channel returned in the real part.
+ * @param S1 Half spectrum of the channel returned in the imaginary part, or NULL.
+ */
+void merge_packed_spectrum(double complex* Z, size_t N, double complex* S0, double complex* S1);
+
+/**
+ * @brief Create the overlap-save state for convolving one x[n] with a partitioned h[n].
+ *
+ * @param ir Partitioned h[n].
+ * @param plan FFT plan of twice the block size.
+ * @param schedule h[n] inputs switched to after ir, or NULL.
+ * @param channels_x x[n] channels.
+ * @param channels Output channels.
+ * @return Block convolution state or NULL.
+ */
+block_conv_t* create_block_conv(partitioned_ir_t* ir, fft_plan_t* plan, ir_schedule_t* schedule, uint8_t channels_x, uint8_t channels);
+
+void destroy_block_conv(block_conv_t* bc);
+
+/**
+ * @brief Convolve the next block of x[n] and output the next block of y[n].
+ *
+ * @param bc Block convolution state.
+ * @param x_block Interleaved x[n] block samples, data may be NULL when frames is 0.
+ * @param frames Frames in x_block, the rest of the block is zero.
+ * @param y_block Interleaved output of block_size frames.
+ */
+void process_block(block_conv_t* bc, samples_t x_block, size_t frames, double* y_block);
+
+/**
+ * @brief Multiply-accumulate every partition of h[n] with the x[n] blocks in the delay line.
+ *
+ * @param bc Block convolution state.
+ * @param ir Partitioned h[n], with the block size of bc.
+ * @param channel Output channel.
+ * @param acc Half spectrum accumulator of block_size + 1 bins.
+ */
+void accumulate_partitions(block_conv_t* bc, partitioned_ir_t* ir, uint8_t channel, double complex* acc);
+
+/**
+ * @brief Output the next block of y[n] with the schedule, mixing the outputs of every h[n] heard in the block by their gains. Two outputs share each inverse FFT, so a crossfade costs one extra inverse FFT per output channel.
+ *
+ * @param bc Block convolution state with a schedule, and the block already in the delay line.
+ * @param y_block Interleaved output of block_size frames.
+ */
+void mix_scheduled_block(block_conv_t* bc, double* y_block);
+
+/**
+ * @brief Set the gain of every h[n] heard in the block. Each h[n] fades in over the ones before it, so the gains always add up to 1.
+ *
+ * @param bc Block convolution state with a schedule.
+ * @param first First h[n] heard in the block, 0 for the first h[n] and i for scheduled input i - 1.
+ * @param last Last h[n] heard in the block.
+ */
+void set_schedule_weights(block_conv_t* bc, size_t first, size_t last);
+
+/**
+ * @brief Get how far the crossfade to a scheduled h[n] is at a frame.
+ *
+ * @param schedule h[n] schedule.
+ * @param entry Scheduled input.
+ * @param frame Frame of y[n].
+ * @return Gain from 0 before the crossfade to 1 after it.
+ */
+double get_fade_gain(const ir_schedule_t* schedule, size_t entry, size_t frame);
+
+/**
+ * @brief Read the h[n] schedule file. Every line has the time in seconds a crossfade starts at, then the h[n] input to switch to.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param schedule_file Path to the schedule.
+ * @return Success or failure.
+ */
+int read_schedule_file(conv_config_t* conv_conf, char* schedule_file);
+
+/**
+ * @brief Read and partition every scheduled h[n] with the block size of the first h[n], and place the crossfades at the sample rate of x[n].
+ *
+ * @param conv_conf Conv Config struct, with h[n] already read.
+ * @return Success or failure.
+ */
+int read_ir_schedule(conv_config_t* conv_conf);
+
+/**
+ * @brief Get the length of the longest h[n], including the scheduled ones.
+ *
+ * @param conv_conf Conv Config struct.
+ * @return Frames.
+ */
+size_t get_ir_frames(conv_config_t* conv_conf);
+
+/**
+ * @brief Get the most channels of any h[n], including the scheduled ones.
+ *
+ * @param conv_conf Conv Config struct.
+ * @return Channels.
+ */
+uint8_t get_ir_channels(conv_config_t* conv_conf);
+
+/**
+ * @brief Convolve x[n] with an already partitioned h[n].
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ir Partitioned h[n].
+ * @param plan FFT plan of twice the block size.
+ * @param x Interleaved x[n] samples.
+ * @param y Interleaved output buffer.
+ * @return Success or failure.
+ */
+int conv_block_partitioned(conv_config_t* conv_conf, partitioned_ir_t* ir, fft_plan_t* plan, samples_t x, double* y);
+
+/**
+ * @brief Convolve every x[n] in the batch with h[n] on a pool of worker threads. h[n] is partitioned and transformed once.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @param h Interleaved h[n] data.
+ * @return Success or failure.
+ */
+int conv_batch_x(conv_config_t* conv_conf, SF_INFO* sf_info_h, double* h);
+
+/**
+ * @brief Batch worker thread. Claims the next x[n], then reads, convolves, and writes it.
+ *
+ * @param arg Batch context.
+ * @return NULL.
+ */
+void* batch_x_worker(void* arg);
+
+/**
+ * @brief Stream x[n] from stdin through the block engine and write every output block to stdout as soon as it is ready. Memory is bounded by h[n] and the block size.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @param h Interleaved h[n] data, or NULL when the spectra came from the cache.
+ * @return Success or failure.
+ */
+int conv_stream(conv_config_t* conv_conf, SF_INFO* sf_info_h, double* h);
+
+/**
+ * @brief Open stdin for x[n], either as raw samples in the layout of the raw options or as a WAV stream.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @param sf_info_x x[n] SF_INFO struct.
+ * @param file Opened stream.
+ * @return Success or failure.
+ */
+int open_stream_input(conv_config_t* conv_conf, SF_INFO* sf_info_h, SF_INFO* sf_info_x, SNDFILE** file);
+
+/**
+ * @brief Open stdout for y[n]. Raw x[n] streams give raw samples of the same type, otherwise the output is text rows and file stays NULL.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_x x[n] SF_INFO struct.
+ * @param file Opened stream.
+ * @return Success or failure.
+ */
+int open_stream_output(conv_config_t* conv_conf, SF_INFO* sf_info_x, SNDFILE** file);
+
+/**
+ * @brief Convolve the x[n] audio file with the block engine as a pipeline straight into the output audio file, so x[n] and y[n] are never held in full.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @param h Interleaved h[n] data, or NULL when the spectra came from the cache.
+ * @return Success or failure.
+ */
+int conv_pipeline(conv_config_t* conv_conf, SF_INFO* sf_info_h, double* h);
+
+/**
+ * @brief Check if the block engine can run as a pipeline from the x[n] file to the output file.
+ *
+ * @param conv_conf Conv Config struct.
+ * @return 1 if it can, 0 otherwise.
+ */
+uint8_t check_pipeline(conv_config_t* conv_conf);
+
+/**
+ * @brief Run x[n] through the block engine on three threads. A reader decodes blocks, the compute stage convolves them, and a writer encodes them, with bounded rings in between. Every stage reports its throughput with '--timer'.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param h Interleaved h[n] data, or NULL when the spectra came from the cache.
+ * @param file_x x[n] input.
+ * @param file_y y[n] output, or NULL for text rows on stdout.
+ * @param format libsndfile subtype of file_y.
+ * @param flush_flag Flush every block, for pipes.
+ * @return Success or failure.
+ */
+int run_block_pipeline(conv_config_t* conv_conf, double* h, SNDFILE* file_x, SNDFILE* file_y, int format, uint8_t flush_flag);
+
+/**
+ * @brief Reader stage. Decodes x[n] blocks into the x[n] ring until a short block ends the input.
+ *
+ * @param arg Pipeline.
+ * @return NULL.
+ */
+void* pipeline_reader(void* arg);
+
+/**
+ * @brief Compute stage. Convolves every x[n] block into a y[n] block, then flushes the h[n] tail.
+ *
+ * @param pl Pipeline.
+ * @return Success or failure.
+ */
+int pipeline_compute(pipeline_t* pl);
+
+/**
+ * @brief Writer stage. Encodes y[n] blocks until a short block ends the output.
+ *
+ * @param arg Pipeline.
+ * @return NULL.
+ */
+void* pipeline_writer(void* arg);
+
+/**
+ * @brief Print the throughput of every pipeline stage, the slowest one is the bottleneck.
+ *
+ * @param pl Pipeline.
+ * @param file Output file.
+ */
+void report_pipeline(pipeline_t* pl, FILE* file);
+
+block_ring_t* create_block_ring(size_t slots, size_t block_samples);
+
+void destroy_block_ring(block_ring_t* ring);
+
+/**
+ * @brief Wait for an empty slot to fill.
+ *
+ * @param ring Block ring.
+ * @return Slot of block_samples doubles, or NULL if the pipeline aborted.
+ */
+double* ring_write_slot(block_ring_t* ring);
+
+/**
+ * @brief Hand the slot from ring_write_slot() to the next stage.
+ *
+ * @param ring Block ring.
+ * @param frames Frames in the slot.
+ */
+void ring_push(block_ring_t* ring, size_t frames);
+
+/**
+ * @brief Wait for the oldest filled slot.
+ *
+ * @param ring Block ring.
+ * @param frames Frames in the slot.
+ * @return Slot, or NULL if the pipeline aborted.
+ */
+double* ring_read_slot(block_ring_t* ring, size_t* frames);
+
+/**
+ * @brief Give the slot from ring_read_slot() back to the previous stage.
+ *
+ * @param ring Block ring.
+ */
+void ring_pop(block_ring_t* ring);
+
+/**
+ * @brief Wake every stage waiting on the ring and make further waits fail.
+ *
+ * @param ring Block ring.
+ */
+void ring_abort(block_ring_t* ring);
+
+/**
+ * @brief Read a full block from a stream. Pipes can return short reads, so a short block only happens at the end.
+ *
+ * @param file Input stream.
+ * @param x_block Block buffer.
+ * @param frames Frames in a block.
+ * @param channels Channels of the stream.
+ * @return Frames read.
+ */
+size_t read_stream_block(SNDFILE* file, double* x_block, size_t frames, uint8_t channels);
+
+/**
+ * @brief Write a block of y[n].
+ *
+ * @param conv_conf Conv Config struct.
+ * @param file y[n] output, or NULL for text rows on stdout.
+ * @param quantizer Converter for file.
+ * @param y_block y[n] block buffer.
+ * @param frames Frames to write.
+ * @param flush_flag Flush the block, for pipes.
+ * @return Success or failure.
+ */
+int write_stream_block(conv_config_t* conv_conf, SNDFILE* file, quantizer_t* quantizer, double* y_block, size_t frames, uint8_t flush_flag);
+
+/**
+ * @brief Select the sample type of raw inputs.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param strval Option value.
+ * @return Success or failure.
+ */
+int select_raw_dtype(conv_config_t* conv_conf, char* strval);
+
+/**
+ * @brief Select the sample type of the audio output.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param strval Option value.
+ * @return Success or failure.
+ */
+int select_out_subtype(conv_config_t* conv_conf, char* strval);
+
+/**
+ * @brief Select the file format of the audio output by its extension, from the major formats of libsndfile.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param strval Option value.
+ * @return Success or failure.
+ */
+int select_out_container(conv_config_t* conv_conf, char* strval);
+
+/**
+ * @brief Check that the '--out-container' given without '--out-subtype' can hold the samples of the audio input the output takes its format from.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param info_x x[n] input, probed.
+ * @param info_h h[n] input, probed.
+ * @return Success or failure.
+ */
+int check_out_container(conv_config_t* conv_conf, input_info_t* info_x, input_info_t* info_h);
+
+/**
+ * @brief Apply the selected output subtype and container to the format of an output, and check libsndfile can write the result.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_y Output SF_INFO struct, copied from an input.
+ * @return Success or failure.
+ */
+int set_output_format(conv_config_t* conv_conf, SF_INFO* sf_info_y);
+
+/**
+ * @brief Map a file into memory for reading.
+ *
+ * @param path File path.
+ * @param map Mapping to fill.
+ * @return Success or failure.
+ */
+int map_file(char* path, mapped_file_t* map);
+
+void unmap_file(mapped_file_t* map);
+
+/**
+ * @brief Hash the content of an input with 64-bit FNV-1a. File inputs hash their bytes and CSV strings hash the string.
+ *
+ * @param input_info Input info struct.
+ * @param hash Content hash.
+ * @return Success or failure.
+ */
+int hash_input(input_info_t* input_info, uint64_t* hash);
+
+/**
+ * @brief Get the cache file of h[n], named after its content hash and the requested block size.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param cache_file Cache file path of size 2 * MAX_STR.
+ * @param hash Content hash of h[n].
+ * @return Success or failure.
+ */
+int get_ir_cache_file(conv_config_t* conv_conf, char* cache_file, uint64_t* hash);
+
+/**
+ * @brief Memory map cached h[n] spectra into conv_conf->ir and fill in the h[n] info without decoding it.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param cache_file Cache file path.
+ * @param hash Content hash of h[n].
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @return Success, or failure when there is no valid cache file.
+ */
+int load_ir_cache(conv_config_t* conv_conf, char* cache_file, uint64_t hash, SF_INFO* sf_info_h);
+
+/**
+ * @brief Store the spectra of conv_conf->ir in the cache. Written to a temporary file first, so concurrent runs never map a partial file.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param cache_file Cache file path.
+ * @param hash Content hash of h[n].
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @return Success or failure.
+ */
+int save_ir_cache(conv_config_t* conv_conf, char* cache_file, uint64_t hash, SF_INFO* sf_info_h);
+
+/**
+ * @brief Read h[n]. With a cache directory set, the cached spectra are mapped instead and h stays NULL, otherwise h[n] is decoded, partitioned, and cached.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @param h Pointer to the h[n] data buffer.
+ * @return Success or failure.
+ */
+int read_ir_input(conv_config_t* conv_conf, SF_INFO* sf_info_h, double** h);
+
+/**
+ * @brief Convolve two audio files chunk by chunk without loading either. Chunk pairs are convolved with FFTs and partial sums are kept in a spill file next to the output. Frames are written out as soon as no later chunk pair adds to them, and the spill file only holds the frames still being added to.
+ *
+ * @param conv_conf Conv Config struct.
+ * @return Success or failure.
+ */
+int conv_out_of_core(conv_config_t* conv_conf);
+
+/**
+ * @brief Get the largest chunk transform that fits the memory limit, and the chunk sizes of each input.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param chunk_x x[n] frames per chunk.
+ * @param chunk_h h[n] frames per chunk.
+ * @return Transform size, 0 if the limit is too small.
+ */
+size_t get_chunk_sizes(conv_config_t* conv_conf, size_t* chunk_x, size_t* chunk_h);
+
+/**
+ * @brief Convolve every pair of x[n] and h[n] chunks and add the results into the spill file. Each x[n] chunk is read and transformed once.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ooc Out-of-core engine state.
+ * @return Success or failure.
+ */
+int spill_chunk_products(conv_config_t* conv_conf, out_of_core_t* ooc);
+
+/**
+ * @brief Add the frames in ooc->y to the spill file, starting at a frame.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ooc Out-of-core engine state.
+ * @param start First output frame.
+ * @param frames Frames to add.
+ * @param final Frames no later chunk pair adds to, the ones past ooc->final_frames are written out instead of being kept.
+ * @return Success or failure.
+ */
+int accumulate_spill(conv_config_t* conv_conf, out_of_core_t* ooc, size_t start, size_t frames, size_t final);
+
+/**
+ * @brief Read or write consecutive frames of the spill file, wrapping around at the end of its window.
+ *
+ * @param ooc Out-of-core engine state.
+ * @param frame First output frame.
+ * @param frames Frames to move.
+ * @param channels Channels per frame.
+ * @param buf Frames to write or the buffer to read into.
+ * @param write_flag Write the frames instead of reading them.
+ * @return Success or failure.
+ */
+int transfer_spill(out_of_core_t* ooc, size_t frame, size_t frames, uint8_t channels, double* buf, uint8_t write_flag);
+
+/**
+ * @brief Add completed frames to the output level, then write them to the output, or to the normalisation spill file as floats when the peak is still needed.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ooc Out-of-core engine state.
+ * @param y Completed frames, scaled in place.
+ * @param frames Frames to write.
+ * @return Success or failure.
+ */
+int write_completed_frames(conv_config_t* conv_conf, out_of_core_t* ooc, double* y, size_t frames);
+
+/**
+ * @brief Seek the spill file to a frame. Uses 64-bit offsets, spill files are larger than 2 GB.
+ *
+ * @param spill Spill file.
+ * @param frame Frame to seek to.
+ * @param channels Channels per frame.
+ * @return Success or failure.
+ */
+int seek_spill(FILE* spill, size_t frame, uint8_t channels);
+
+/**
+ * @brief Second pass of normalising, stream the normalisation spill file to the output in chunks, scaled by the peak tracked in the first pass.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param ooc Out-of-core engine state.
+ * @return Success or failure.
+ */
+int write_norm_spill(conv_config_t* conv_conf, out_of_core_t* ooc);
+
+/**
+ * @brief Get the number of online CPUs.
+ *
+ * @return CPU count.
+ */
+uint16_t get_cpu_count();
+
+/**
+ * @brief Get the next power of two.
+ *
+ * @param n Input number.
+ * @return Smallest power of two greater or equal to n.
+ */
+size_t nextpow2(size_t n);
+
+/**
+ * @brief Reverse the lowest bits of an index.
+ *
+ * @param index Index to reverse.
+ * @param bits Number of bits in the index.
+ * @return Bit reversed index.
+ */
+size_t index_bit_reversal(size_t index, uint8_t bits);
+
+/**
+ * @brief Get the forward twiddle factor W_N^k.
+ *
+ * @param k Index.
+ * @param N Transform size.
+ * @return Twiddle factor.
+ */
+double complex get_twiddle_factor(size_t k, size_t N);
+
+/**
+ * @brief Multiply two complex numbers without the NaN/Inf recovery of the C99 complex operator.
+ *
+ * @param a First number.
+ * @param b Second number.
+ * @return Product.
+ */
+double complex complex_mul(double complex a, double complex b);
+
+/**
+ * @brief Precompute the twiddle factors and bit reversal table for an N point FFT.
+ *
+ * @param N Transform size, must be a power of two.
+ * @return FFT plan.
+ */
+fft_plan_t* create_fft_plan(size_t N);
+
+void destroy_fft_plan(fft_plan_t* plan);
+
+/**
+ * @brief In-place iterative radix-2 DIT FFT. The inverse is left unscaled.
+ *
+ * @param plan FFT plan.
+ * @param X Data buffer of size plan->N.
+ * @param inverse Set for the inverse transform.
+ */
+void fft(fft_plan_t* plan, double complex* X, uint8_t inverse);
+
+/**
+ * @brief In-place 2-D FFT of a matrix stored row by row, made of FFTs of every row and then every column. The inverse runs the columns first and is left unscaled.
+ *
+ * @param row_plan FFT plan with the row length.
+ * @param column_plan FFT plan with the column length.
+ * @param Z Data buffer of column_plan->N rows of row_plan->N values.
+ * @param rows Rows that are not zero going forward, or rows needed coming back.
+ * @param column Buffer of size column_plan->N.
+ * @param inverse Set for the inverse transform.
+ */
+void fft_2d(fft_plan_t* row_plan, fft_plan_t* column_plan, double complex* Z, size_t rows, double complex* column, uint8_t inverse);
+
+/**
+ * @brief Pack two channels of interleaved samples into one zero padded complex buffer.
+ *
+ * @param Z Complex buffer of size N.
+ * @param N Transform size.
+ * @param x Interleaved samples.
+ * @param frames Frames in the buffer.
+ * @param channels Channels in the buffer.
+ * @param re Channel placed in the real part.
+ * @param im Channel placed in the imaginary part, or NO_CHANNEL.
+ */
+void pack_channel_pair(double complex* Z, size_t N, samples_t x, size_t frames, uint8_t channels, uint8_t re, int16_t im);
+
+/**
+ * @brief Unpack an inverse transformed channel pair into an interleaved buffer, applying the 1/N scaling.
+ *
+ * @param Y Complex buffer of size N.
+ * @param N Transform size.
+ * @param y Interleaved buffer.
+ * @param frames Frames to write.
+ * @param channels Channels in the buffer.
+ * @param re Channel taken from the real part.
+ * @param im Channel taken from the imaginary part, or NO_CHANNEL.
+ * @param stats Output level to add the frames to, or NULL for partial sums.
+ */
+void unpack_channel_pair(double complex* Y, size_t N, double* y, size_t frames, uint8_t channels, uint8_t re, int16_t im, output_stats_t* stats);
+
+/**
+ * @brief Transform an interleaved input into channel pair spectra laid out for the output channels.
+ *
+ * @param plan FFT plan.
+ * @param x Interleaved samples.
+ * @param frames Frames in the buffer.
+ * @param channels Channels in the buffer.
+ * @param out_channels Output channels. Output channel c reads input channel c % channels.
+ * @param S Spectra to fill.
+ * @return Success or failure.
+ */
+int transform_channels(fft_plan_t* plan, samples_t x, size_t frames, uint8_t channels, uint8_t out_channels, spectra_t* S);
+
+void free_spectra(spectra_t* S);
+
+/**
+ * @brief Multiply two packed channel pair spectra and accumulate into Y. Both pairs are separated by conjugate symmetry unless one of them is shared.
+ *
+ * @param Y Output spectrum, holds the two channel results in its real and imaginary parts after the inverse.
+ * @param A First packed spectrum.
+ * @param a_shared A holds a single real channel.
+ * @param B Second packed spectrum.
+ * @param b_shared B holds a single real channel.
+ * @param N Transform size.
+ */
+void multiply_spectra(double complex* Y, double complex* A, uint8_t a_shared, double complex* B, uint8_t b_shared, size_t N);
+
+/**
+ * @brief Replace the transform of x[n] + jh[n] with the spectrum of x[n]*h[n].
+ *
+ * @param Z Packed spectrum.
+ * @param N Transform size.
+ */
+void multiply_packed_inputs(double complex* Z, size_t N);
+
+/**
+ * @brief Replace the 2-D transform of x[n] + jh[n] with the spectrum of their 2-D convolution.
+ *
+ * @param Z Packed spectrum, row by row.
+ * @param rows Transform rows.
+ * @param columns Transform columns.
+ */
+void multiply_packed_inputs_2d(double complex* Z, size_t rows, size_t columns);
+
+/**
+ * @brief Replace a bin of a packed spectrum and its conjugate bin with the product spectrum.
+ *
+ * @param Z Packed spectrum.
+ * @param k Bin.
+ * @param kc Conjugate bin.
+ */
+static inline void multiply_packed_pair(double complex* Z, size_t k, size_t kc)
+{
+    const double complex zk = Z[k];
+    const double complex zc = Z[kc];
+    const double complex yk = complex_mul(zk, zk) - complex_mul(conj(zc), conj(zc));
+    const double complex yc = complex_mul(zc, zc) - complex_mul(conj(zk), conj(zk));
+
+    /* Division by 4j */
+    Z[k] = CMPLX(cimag(yk), -creal(yk)) * 0.25;
+    Z[kc] = CMPLX(cimag(yc), -creal(yc)) * 0.25;
+}
+
+/**
+ * @brief Get a date and time string in HHMMSSddmmyy format.
+ *
+ * @return Date/time string.
+ */
+char* get_datetime_string();
+
+/**
+ * @brief Get the extension from the input file name.
+ *
+ * @param ifile_name Input file name to the function. 
+ * @return Blank string or extension.
+ */
+char* get_extension(char* ifile_name);
+
+/**
+ * @brief Get the file name without its directories, so outputs of inputs from other directories are written to the current one.
+ *
+ * @param ifile_name Input file name.
+ * @return Pointer to the base name inside ifile_name.
+ */
+char* get_base_name(char* ifile_name);
+
+/**
+ * @brief Generate the output file name based on the input flag and the input file name.
+ *
+ * @param ofile Output file name.
+ * @param ifile Input file name.
+ * @param input_flag Input flag to distinguish between CSV file and string.
+ * @param extension Output extension without the dot, NULL to use the one of h[n].
+ */
+void generate_file_name(char* ofile, input_info_t* input_info, uint8_t input_flag, const char* extension);
+
+/**
+ * @brief Select the output format.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param strval Option value.
+ * @return Success or failure.
+ */
+int select_output_format(conv_config_t* conv_conf, char* strval);
+
+int read_audio_file_input(input_info_t* conv_conf, SF_INFO* sf_info, double** x);
+
+/**
+ * @brief Map the data chunk of a plain WAV file so the kernels read its samples in place. Only 16/32-bit PCM and 32/64-bit float on little-endian hosts are mapped.
+ *
+ * @param input_info Input info struct.
+ * @param sf_info Input SF_INFO struct, filled from the WAV header.
+ * @return Success, or failure when the file should go through libsndfile.
+ */
+int map_wav_input(input_info_t* input_info, SF_INFO* sf_info);
+
+/**
+ * @brief Find the format and the data chunk of a WAV file.
+ *
+ * @param data File contents.
+ * @param size File size.
+ * @param sf_info SF_INFO struct to fill.
+ * @param data_offset Offset of the samples.
+ * @return Success or failure.
+ */
+int parse_wav_header(const unsigned char* data, size_t size, SF_INFO* sf_info, size_t* data_offset);
+
+/**
+ * @brief Free a decoded input, or unmap it if it was mapped.
+ *
+ * @param input_info Input info struct.
+ * @param x Decoded buffer.
+ */
+void release_input(input_info_t* input_info, double* x);
+
+/**
+ * @brief Close the audio file and free the CSV values kept by the probe, for inputs that will not use them.
+ *
+ * @param input_info Input info struct.
+ */
+void close_probe(input_info_t* input_info);
+
+/**
+ * @brief Take the audio file opened by the probe, or open it again if it was already taken.
+ *
+ * @param input_info Input info struct.
+ * @param file Pointer to the SNDFILE pointer.
+ * @param sf_info Input SF_INFO struct.
+ * @return Success or failure.
+ */
+int open_input_file(input_info_t* input_info, SNDFILE** file, SF_INFO* sf_info);
+
+/**
+ * @brief Open the audio file.
+ *
+ * @param file Pointer to SNDFILE pointer.
+ * @param sf_info SF_INFO type from libsndfile.
+ * @param ibuff Input buffer of size MAX_STR 
+ * @return Success or failure.
+ */
+int open_audio_file(SNDFILE** file, SF_INFO* sf_info, char* ibuff);
+
+/**
+ * @brief Get the data from the audio file.
+ *
+ * @param file SNDFILE pointer.
+ * @param sf_info SF_INFO type from libsndfile.
+ * @param x Pointer to data buffer.
+ * @return Success or failure.
+ */
+int get_audio_file_data(SNDFILE* file, SF_INFO* sf_info, double** x);
+
+/**
+ * @brief Read 16-bit PCM audio file data as it is with sf_readf_short, into the native samples of the input.
+ *
+ * @param file SNDFILE pointer.
+ * @param sf_info SF_INFO type from libsndfile.
+ * @param input_info Input info struct to hold the samples.
+ * @return Success or failure.
+ */
+int get_audio_file_shorts(SNDFILE* file, SF_INFO* sf_info, input_info_t* input_info);
+
+
+/**
+ * @brief Get the SNDFILE major format string. Same as descriptions given in the documentation.
+ *
+ * @param sf_info Pointer to SF_INFO variable containing file information.
+ * @return Major format string
+ */
+const char* get_sndfile_major_format(SF_INFO* sf_info);
+
+/**
+ * @brief Get the SNDFILE subtype string. Same as subtypes given in the documentation.
+ *
+ * @param sf_info Pointer to SF_INFO variable containing file information.
+ * @return Subtype string.
+ */
+const char* get_sndfile_subtype(SF_INFO* sf_info);
+
+/**
+ * @brief Check if the input is a CSV string, which is more than one value. The values are parsed and kept for the reader.
+ *
+ * @param input_info Input info struct.
+ * @return Success or failure.
+ */
+int probe_csv_string(input_info_t* input_info);
+
+/**
+ * @brief Check the extension in the input buffer if it can be read like a CSV.
+ *
+ * @param ibuff Input buffer.
+ * @return Success or failure.
+ */
+int check_csv_extension(char* ibuff);
+
+/**
+ * @brief Check if the extension is one used for raw sample files.
+ *
+ * @param extension Input extension.
+ * @return Success or failure.
+ */
+int check_raw_extension(char* extension);
+
+/**
+ * @brief Check if the input type is CSV text, which has no size until it is parsed.
+ *
+ * @param input_type Input type char.
+ * @return 1 if it is, 0 otherwise.
+ */
+uint8_t check_text_input(char input_type);
+
+/**
+ * @brief Give raw inputs the sample type and channels from '--raw-dtype' and '--raw-channels', and their sizes from the file sizes.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param input_info Input info struct.
+ * @return Success or failure.
+ */
+int set_raw_input(conv_config_t* conv_conf, input_info_t* input_info);
+
+/**
+ * @brief Map a raw sample file so the kernels read it in place.
+ *
+ * @param input_info Input info struct, with the sample type and channels set.
+ * @param sf_info Input SF_INFO struct. Unused in this function.
+ * @param x Set to NULL, nothing is decoded.
+ * @return Success or failure.
+ */
+int read_raw_input(input_info_t* input_info, SF_INFO* sf_info, double** x);
+
+/**
+ * @brief Map a NumPy .npy file so the kernels read its array in place. Arrays of 'f8', 'f4', 'i2', or 'i4' with a (frames,) or C ordered (frames, channels) shape are supported. Integers are scaled like PCM samples.
+ *
+ * @param input_info Input info struct.
+ * @param sf_info Input SF_INFO struct. Unused in this function.
+ * @param x Set to NULL, nothing is decoded.
+ * @return Success or failure.
+ */
+int read_npy_input(input_info_t* input_info, SF_INFO* sf_info, double** x);
+
+/**
+ * @brief Find the sample type, the shape, and the data of a .npy file.
+ *
+ * @param data File contents.
+ * @param size File size.
+ * @param format Sample type as a libsndfile subtype.
+ * @param frames Frames of the array.
+ * @param channels Channels of the array.
+ * @param data_offset Offset of the array data.
+ * @return Success or failure.
+ */
+int parse_npy_header(const unsigned char* data, size_t size, int* format, size_t* frames, uint8_t* channels, size_t* data_offset);
+
+/**
+ * @brief Read the input as a CSV file or CSV string.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param x Pointer to data buffer.
+ * @return Success or failure.
+ */
+int read_csv_string_file_input(input_info_t* input_data, SF_INFO* sf_info, double** x);
+
+/**
+ * @brief Set the channels of a parsed CSV input, pairing the values up as I,Q with '--complex'.
+ *
+ * @param input_info Input info struct.
+ * @return Success or failure.
+ */
+int set_csv_layout(input_info_t* input_info);
+
+/**
+ * @brief Count the rows of a matrix CSV input. Every line with values is a row, and all of them need the same number of values.
+ *
+ * @param input_info Input info struct, with the values already parsed.
+ * @param data CSV text.
+ * @param size Text size.
+ * @return Success or failure.
+ */
+int set_matrix_layout(input_info_t* input_info, const char* data, size_t size);
+
+/**
+ * @brief Parse CSV text without copying it. Values can be separated by commas, whitespace, and newlines, so rows, columns, and both in one file are read. Large texts are split into chunks parsed on their own threads.
+ *
+ * @param data CSV text, which does not need a terminator.
+ * @param size Text size.
+ * @param x Pointer to buffer to store the data.
+ * @param detected_samples Variable to store the number of values.
+ * @param name Input name for the error messages.
+ * @param threads Threads to parse with, 0 for every CPU.
+ * @return Success or failure.
+ */
+int parse_csv_data(const char* data, size_t size, double** x, size_t* detected_samples, const char* name, uint16_t threads);
+
+/**
+ * @brief Parse CSV text in a single pass into a buffer that grows as values are found.
+ *
+ * @param data CSV text.
+ * @param size Text size.
+ * @param x Pointer to buffer to store the data.
+ * @param detected_samples Variable to store the number of values, which may be zero.
+ * @param name Input name for the error messages, or NULL to stay quiet.
+ * @return Success or failure.
+ */
+int parse_csv_values(const char* data, size_t size, double** x, size_t* detected_samples, const char* name);
+
+/**
+ * @brief Split CSV text on separators into a chunk per thread and parse them at the same time. The chunk values are placed one after the other using a prefix sum of their counts.
+ *
+ * @param data CSV text.
+ * @param size Text size.
+ * @param x Pointer to buffer to store the data.
+ * @param detected_samples Variable to store the number of values.
+ * @param name Input name for the error messages.
+ * @param threads Chunks to split the text into.
+ * @return Success or failure.
+ */
+int parse_csv_parallel(const char* data, size_t size, double** x, size_t* detected_samples, const char* name, uint16_t threads);
+
+/**
+ * @brief Parse a CSV chunk.
+ *
+ * @param arg CSV chunk.
+ * @return NULL.
+ */
+void* csv_chunk_worker(void* arg);
+
+/**
+ * @brief Parse one number. Values with up to 19 digits and a power of ten that is exact in a double are converted directly, anything else goes through strtod().
+ *
+ * @param start Start of the value.
+ * @param end End of the value.
+ * @param value Variable to store the number.
+ * @return Success or failure.
+ */
+int parse_double(const char* start, const char* end, double* value);
+
+/**
+ * @brief Get a power of ten that is exact in a double.
+ *
+ * @param exponent Exponent up to MAX_EXACT_POW10.
+ * @return Power of ten.
+ */
+double get_exact_pow10(uint8_t exponent);
+
+/**
+ * @brief Check if the character separates CSV values.
+ *
+ * @param c Character.
+ * @return 1 if it does, 0 otherwise.
+ */
+static inline uint8_t check_csv_separator(char c)
+{
+    return c == ',' || c == ' ' || c == '\n' || c == '\r' || c == '\t';
+}
+
+void show_input_info(input_info_t* input_info, SF_INFO* sf_info);
+
+/**
+ * @brief Format a sample as text, the same as printf() with "%.*lf" for a fixed precision. Samples the fast path cannot round exactly go through snprintf().
+ *
+ * @param buf Buffer with room for MAX_SAMPLE_CHARS.
+ * @param value Sample.
+ * @param precision Decimal places, or SHORTEST_PRECISION for the shortest of "%.15g", "%.16g", and "%.17g" that reads back as the same double.
+ * @return Characters written, without a terminator.
+ */
+size_t format_sample(char* buf, double value, uint8_t precision);
+
+/**
+ * @brief Format a sample with a fixed number of decimal places.
+ *
+ * @param buf Buffer with room for MAX_SAMPLE_CHARS.
+ * @param value Sample.
+ * @param precision Decimal places.
+ * @return Characters written.
+ */
+size_t format_fixed(char* buf, double value, uint8_t precision);
+
+/**
+ * @brief Format a sample with the fewest significant digits that read back as the same double.
+ *
+ * @param buf Buffer with room for MAX_SAMPLE_CHARS.
+ * @param value Sample.
+ * @return Characters written.
+ */
+size_t format_shortest(char* buf, double value);
+
+/**
+ * @brief Select the output precision, either a number of decimal places or 'shortest'.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param strval Precision string.
+ * @return Success or failure.
+ */
+int select_precision(conv_config_t* conv_conf, char* strval);
+
+int (*autoset_output_format(char type_x, char type_h)) (conv_config_t*, SF_INFO*, double*);
+
+/**
+ * @brief Check if the timer should be stopped and outputed.
+ *
+ * @param conv_conf Conv Config struct.
+ */
+void check_timer_end_output(conv_config_t* conv_conf);
+
+/**
+ * @brief Output result to stdout.
+ *
+ * @param conv_conf WindFcn config struct.
+ * @param sf_info Input file SF_INFO struct. Unused in this function.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_stdout(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Output result to stdout as CSVs.
+ *
+ * @param conv_conf WindFcn config struct.
+ * @param sf_info Input file SF_INFO struct. Unused in this function.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_stdout_csv(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Output result to a file as a column.
+ *
+ * @param conv_conf WindFcn config struct.
+ * @param sf_info Input file SF_INFO struct. Unused in this function.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_file_columns(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Output result to a CSV file.
+ *
+ * @param conv_conf WindFcn config struct.
+ * @param sf_info Input file SF_INFO struct. Unused in this function.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_file_csv(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Output result as raw interleaved 64-bit floats in host byte order, written in one piece.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info Input file SF_INFO struct. Unused in this function.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_file_raw_f64(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Output result as raw interleaved 32-bit floats in host byte order.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info Input file SF_INFO struct. Unused in this function.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_file_raw_f32(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Output result as a NumPy .npy file of 64-bit floats. The shape is (frames,) for one channel and (frames, channels) otherwise.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info Input file SF_INFO struct. Unused in this function.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_file_npy(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Make the .npy header for the result, padded so the data is aligned.
+ *
+ * @param header Buffer of NPY_MAX_HEADER bytes.
+ * @param frames Frames, or rows of a 2-D result.
+ * @param channels Channels, or columns of a 2-D result.
+ * @param matrix_flag Keep both dimensions of a 2-D result, even with a single column.
+ * @return Header length.
+ */
+size_t make_npy_header(char header[NPY_MAX_HEADER], size_t frames, size_t channels, uint8_t matrix_flag);
+
+/**
+ * @brief Write a header and the data to a binary output file. Unscaled doubles go out with a single write, otherwise the data is scaled and converted in chunks.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param header Header bytes, or NULL.
+ * @param header_size Header size in bytes.
+ * @param x Interleaved data buffer.
+ * @param sample_size Bytes per written sample, sizeof(double) or sizeof(float).
+ * @return Success or failure.
+ */
+int write_binary_output(conv_config_t* conv_conf, const void* header, size_t header_size, double* x, size_t sample_size);
+
+/**
+ * @brief Make the converter for an audio output of a libsndfile subtype.
+ *
+ * @param format libsndfile subtype of the output.
+ * @param clip_flag Scale like libsndfile's clipping conversion, with full scale at 2^(bits - 1), as streams to stdout are.
+ * @return Quantizer, or NULL if it could not be allocated.
+ */
+quantizer_t* create_quantizer(int format, uint8_t clip_flag);
+
+/**
+ * @brief Free a quantizer.
+ *
+ * @param quantizer Quantizer, or NULL.
+ */
+void destroy_quantizer(quantizer_t* quantizer);
+
+/**
+ * @brief Warn about the samples that were clipped by a quantizer.
+ *
+ * @param quantizer Quantizer.
+ */
+void report_clipping(quantizer_t* quantizer);
+
+/**
+ * @brief Scale frames of y[n] and write them to an audio output in chunks. Fixed-point outputs are quantized and handed to libsndfile as native shorts or ints.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param file Audio output.
+ * @param quantizer Converter for the output.
+ * @param y Interleaved frames.
+ * @param frames Frames to write.
+ * @return Success or failure.
+ */
+int write_audio_frames(conv_config_t* conv_conf, SNDFILE* file, quantizer_t* quantizer, double* y, size_t frames);
+
+/**
+ * @brief Fill the noise buffer with TPDF dither of one step peak, the difference of two uniform values.
+ *
+ * @param quantizer Quantizer.
+ * @param count Samples of dither.
+ */
+void fill_dither(quantizer_t* quantizer, size_t count);
+
+/**
+ * @brief Quantize samples to 16-bit. The loop has no branches, so the compiler vectorizes it.
+ *
+ * @param x Samples.
+ * @param count Samples to quantize.
+ * @param gain Full scale times the output scale.
+ * @param noise Dither in steps.
+ * @param out Quantized samples.
+ * @return Clipped samples.
+ */
+size_t quantize_short(const double* x, size_t count, double gain, const double* noise, int16_t* out);
+
+/**
+ * @brief Quantize samples to 24 or 32-bit, given to libsndfile as ints. The loop has no branches, so the compiler vectorizes it.
+ *
+ * @param x Samples.
+ * @param count Samples to quantize.
+ * @param gain Full scale times the output scale.
+ * @param noise Dither in steps.
+ * @param min Smallest sample of the format.
+ * @param max Largest sample of the format.
+ * @param step Int step of one sample.
+ * @param out Quantized samples.
+ * @return Clipped samples.
+ */
+size_t quantize_int(const double* x, size_t count, double gain, const double* noise, double min, double max, int32_t step, int32_t* out);
+
+/**
+ * @brief Round a quantized sample to the nearest integer, ties to even, after limiting it to the range of the format.
+ *
+ * @param v Sample in steps.
+ * @param min Smallest sample.
+ * @param max Largest sample.
+ * @return Rounded sample.
+ */
+static inline double round_sample(double v, double min, double max)
+{
+    v = v > max ? max : v;
+    v = v < min ? min : v;
+
+    return (v + ROUND_MAGIC) - ROUND_MAGIC;
+}
+
+/**
+ * @brief Output result as an audio file.
+ *
+ * @param conv_conf WindFcn config struct.
+ * @param sf_info Input file SF_INFO struct.
+ * @param x Data buffer.
+ * @return Success or failure.
+ */
+int output_file_audio(conv_config_t* conv_conf, SF_INFO* sf_info, double* x);
+
+/**
+ * @brief Write the data as one row per frame, with the channels separated by commas. A 2-D output is written a row of the matrix per line.
+ *
+ * @param file Output file.
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved data buffer.
+ */
+void write_columns(FILE* file, conv_config_t* conv_conf, double* x);
+
+/**
+ * @brief Write frames as one row per frame, with the channels separated by commas.
+ *
+ * @param file Output file.
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved data buffer.
+ * @param frames Frames to write.
+ */
+void write_frames(FILE* file, conv_config_t* conv_conf, double* x, size_t frames);
+
+/**
+ * @brief Write the data as one comma separated row per channel. A 2-D output is written a row of the matrix per line.
+ *
+ * @param file Output file.
+ * @param conv_conf Conv Config struct.
+ * @param x Interleaved data buffer.
+ */
+void write_csv_rows(FILE* file, conv_config_t* conv_conf, double* x);
+
+/**
+ * @brief Format samples as text and write them. Long outputs are split into chunks that are formatted on worker threads and written in order, giving the same bytes as one thread.
+ *
+ * @param file Output file.
+ * @param conv_conf Conv Config struct.
+ * @param x Data buffer.
+ * @param count Samples to write.
+ * @param stride Distance between the samples.
+ * @param row Samples in each row, the last one is followed by a newline instead of a comma.
+ */
+void write_text(FILE* file, conv_config_t* conv_conf, double* x, size_t count, size_t stride, size_t row);
+
+/**
+ * @brief Format a range of samples into a buffer and write it out whenever it fills.
+ *
+ * @param file Output file.
+ * @param x Data buffer.
+ * @param first Index of the first sample.
+ * @param count Samples to write.
+ * @param stride Distance between the samples.
+ * @param row Samples in each row.
+ * @param precision Output precision.
+ * @param scale Factor applied to every sample.
+ */
+void write_text_range(FILE* file, double* x, size_t first, size_t count, size_t stride, size_t row, uint8_t precision, double scale);
+
+/**
+ * @brief Format the chunks of the text output on a thread each, then write them in order. Repeats until every sample is written.
+ *
+ * @param file Output file.
+ * @param conv_conf Conv Config struct.
+ * @param x Data buffer.
+ * @param count Samples to write.
+ * @param stride Distance between the samples.
+ * @param row Samples in each row.
+ * @param threads Chunks formatted at a time.
+ * @return Success or failure. Nothing is written on failure.
+ */
+int write_text_parallel(FILE* file, conv_config_t* conv_conf, double* x, size_t count, size_t stride, size_t row, uint16_t threads);
+
+/**
+ * @brief Format a text chunk into its buffer, growing it as needed.
+ *
+ * @param arg Text chunk.
+ * @return NULL.
+ */
+void* text_chunk_worker(void* arg);
+
+/**
+ * @brief Get the scale the output writers apply, the reciprocal of the tracked peak when normalising.
+ *
+ * @param conv_conf Conv Config struct.
+ * @return Output scale.
+ */
+double get_output_scale(conv_config_t* conv_conf);
+
+/**
+ * @brief Show the peak and RMS level of the output before any normalisation, and the headroom left by the peak bound.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param file Where to show it, stderr when stdout carries a stream.
+ */
+void show_output_level(conv_config_t* conv_conf, FILE* file);
+
+/**
+ * @brief Set the output scale from a bound of the output peak, worked out before y[n] is computed. Every output channel is bounded by the peak of its x[n] channel times the sum of the absolute samples of its h[n] channel.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param file_x x[n] file to scan, which is then sought back to its start, or NULL.
+ * @param x Decoded x[n], NULL when mapped or read from a file. A stream is taken at full scale.
+ * @param file_h h[n] file to scan, or NULL.
+ * @param h Decoded h[n], NULL when mapped or read from a file.
+ * @return Success or failure.
+ */
+int set_norm_bound(conv_config_t* conv_conf, SNDFILE* file_x, double* x, SNDFILE* file_h, double* h);
+
+/**
+ * @brief Add the samples of every channel to a running peak and a running sum of absolute values.
+ *
+ * @param x Interleaved samples.
+ * @param frames Frames to add.
+ * @param channels Channels in the samples.
+ * @param peak Peak of every channel, or NULL.
+ * @param sum Sum of every channel, or NULL.
+ */
+void add_channel_levels(samples_t x, size_t frames, uint8_t channels, double* peak, double* sum);
+
+/**
+ * @brief Read a file in chunks for the peak or the absolute sum of every channel, then seek it back to its start.
+ *
+ * @param file Input file.
+ * @param channels Channels in the file.
+ * @param peak Peak of every channel, or NULL.
+ * @param sum Sum of every channel, or NULL.
+ * @return Success or failure.
+ */
+int scan_file_levels(SNDFILE* file, uint8_t channels, double* peak, double* sum);
+
+/**
+ * @brief Normalise, name, and output the result of one convolution.
+ *
+ * @param conv_conf Conv Config struct.
+ * @param sf_info_x x[n] SF_INFO struct.
+ * @param sf_info_h h[n] SF_INFO struct.
+ * @param y Interleaved output data.
+ * @return Success or failure.
+ */
+int write_output(conv_config_t* conv_conf, SF_INFO* sf_info_x, SF_INFO* sf_info_h, double* y);
 
 /**
  * @brief Output the '--help' option.
@@ -1,16 +1,12 @@
 #include "conv.h"
 
 // TODO: Do one with padding and one without. Maybe do different types e.g. fast convolution
-// TODO: Check normalise_data function in DFTT because it might act weird with neg nums
-// TODO: Multiple channels? Choose the sf_info with the most channels
-// TODO: Using two songs is too slow. Solution?
 // FIX: --info output
 
 int main(int argc, char** argv)
 {
     SF_INFO sf_info_x = {0};
     SF_INFO sf_info_h = {0};
-    SF_INFO sf_info_y = {0};
     double* x = NULL;
     double* h = NULL;
     double* y = NULL;
@@ -20,9 +16,84 @@ int main(int argc, char** argv)
 
     CHECK_ERR(get_options(argc, argv, &conv_conf));
 
-    /* Read both the inputs */
-    conv_conf.input_info[X_INDEX].inp(&conv_conf.input_info[X_INDEX], &sf_info_x, &x);
-    conv_conf.input_info[H_INDEX].inp(&conv_conf.input_info[H_INDEX], &sf_info_h, &h);
+    /* Read h[n] and convolve every x[n] in the batch with it */
+    if (conv_conf.batch_count && conv_conf.batch_index == X_INDEX) {
+        CHECK_ERR(read_ir_input(&conv_conf, &sf_info_h, &h));
+
+        if (conv_conf.info_flag && !conv_conf.quiet_flag) {
+            fprintf(stdout, "\n--INFO--");
+            fprintf(stdout, "\n\t=H INPUT=\n");
+            show_input_info(&conv_conf.input_info[H_INDEX], &sf_info_h);
+            fprintf(stdout, "---\n\n");
+        }
+
+        CHECK_ERR(conv_batch_x(&conv_conf, &sf_info_h, h));
+
+        return 0;
+    }
+
+    /* Stream x[n] from stdin, only h[n] is read in full */
+    if (conv_conf.stream_flag) {
+        CHECK_ERR(read_ir_input(&conv_conf, &sf_info_h, &h));
+        CHECK_ERR(conv_stream(&conv_conf, &sf_info_h, h));
+
+        return 0;
+    }
+
+    /* Run the block engine as a pipeline from the x[n] file to the output file */
+    if (check_pipeline(&conv_conf)) {
+        CHECK_ERR(read_ir_input(&conv_conf, &sf_info_h, &h));
+
+        if (conv_conf.schedule.count) {
+            CHECK_ERR(read_ir_schedule(&conv_conf));
+        }
+
+        fprintf(stdout, "Executing convolution...\n");
+        check_timer_start(&conv_conf);
+
+        CHECK_ERR(conv_pipeline(&conv_conf, &sf_info_h, h));
+
+        check_timer_end_output(&conv_conf);
+        fprintf(stdout, "Convolution finished.\n");
+
+        return 0;
+    }
+
+    /* Convolve from disk in chunks that fit the memory limit */
+    if (conv_conf.mem_limit) {
+        fprintf(stdout, "Executing convolution...\n");
+        check_timer_start(&conv_conf);
+
+        CHECK_ERR(conv_out_of_core(&conv_conf));
+
+        check_timer_end_output(&conv_conf);
+        fprintf(stdout, "Convolution finished.\n");
+
+        return 0;
+    }
+
+    /* Read x[n] and convolve it with every h[n] in the batch */
+    if (conv_conf.batch_count) {
+        CHECK_ERR(conv_conf.input_info[X_INDEX].inp(&conv_conf.input_info[X_INDEX], &sf_info_x, &x));
+
+        if (conv_conf.info_flag && !conv_conf.quiet_flag) {
+            fprintf(stdout, "\n--INFO--");
+            fprintf(stdout, "\n\t=X INPUT=\n");
+            show_input_info(&conv_conf.input_info[X_INDEX], &sf_info_x);
+            fprintf(stdout, "---\n\n");
+        }
+
+        CHECK_ERR(conv_batch_h(&conv_conf, &sf_info_x, x));
+
+        return 0;
+    }
+
+    /* Read both the inputs at the same time */
+    CHECK_ERR(read_inputs(&conv_conf, &sf_info_x, &sf_info_h, &x, &h));
+
+    if (conv_conf.norm_bound_flag) {
+        CHECK_ERR(set_norm_bound(&conv_conf, NULL, x, NULL, h));
+    }
 
     if (conv_conf.info_flag && !conv_conf.quiet_flag) {
        fprintf(stdout, "\n--INFO--");
@@ -33,51 +104,57 @@ int main(int argc, char** argv)
        fprintf(stdout, "---\n\n");
     }
 
+    /* Scheduled h[n] inputs can be longer and have more channels, so they are read before y[n] is sized */
+    if (conv_conf.schedule.count) {
+        CHECK_ERR(read_ir_schedule(&conv_conf));
+    }
+
     /* Get the largest total samples from the inputs */
     size_t size_x = conv_conf.input_info[X_INDEX].data_samples;
-    size_t size_h = conv_conf.input_info[H_INDEX].data_samples;
+    size_t size_h = get_ir_frames(&conv_conf);
     size_t size_y = size_x + size_h - 1;
 
     conv_conf.total_samples = size_y;
-    conv_conf.channels = conv_conf.input_info[X_INDEX].channels > conv_conf.input_info[H_INDEX].channels ? conv_conf.input_info[X_INDEX].channels : conv_conf.input_info[H_INDEX].channels;
+    conv_conf.channels = conv_conf.input_info[X_INDEX].channels > get_ir_channels(&conv_conf) ? conv_conf.input_info[X_INDEX].channels : get_ir_channels(&conv_conf);
+
+    /* I/Q inputs give a complex output, stored as its I and Q channels */
+    if (conv_conf.complex_flag) {
+        CHECK_ERR(check_complex_channels(&conv_conf));
+    }
+
+    /* Matrices give a matrix output, stored row by row */
+    if (conv_conf.matrix_flag) {
+        CHECK_ERR(set_matrix_output(&conv_conf, h));
+        size_y = conv_conf.total_samples;
+    }
 
     /* Allocate output array */
-    y = calloc(sizeof(double), size_y);
+    y = calloc(sizeof(double), size_y * conv_conf.channels);
+    if (y == NULL) {
+        fprintf(stderr, "\nUnable to allocate the %zu output samples.\n", size_y * conv_conf.channels);
+    }
+    CHECK_ERR(y == NULL);
+
+    /* If no engine is specified, set it based on the input sizes */
+    if (conv_conf.conv_fcn == NULL) {
+        conv_conf.conv_fcn = autoset_engine(&conv_conf, size_x, size_h);
+    }
 
     fprintf(stdout, "Executing convolution...\n");
 
     /* Start timer */
     check_timer_start(&conv_conf);
 
-    /* Execute convolution sum */
-    conv(x, size_x, h, size_h, y, size_y);
+    /* Execute convolution */
+    CHECK_ERR(conv_conf.conv_fcn(&conv_conf, x, h, y));
 
     /* Stop timer and output */
     check_timer_end_output(&conv_conf);
 
     fprintf(stdout, "Convolution finished.\n");
 
-    /* If no output type is specified, set it based on inputs */
-    if (conv_conf.outp == NULL) {
-        conv_conf.outp = autoset_output_format(conv_conf.input_info[X_INDEX].input_type, conv_conf.input_info[H_INDEX].input_type);
-    }
-
-    /* Normalise data */
-    if (conv_conf.norm_flag) {
-        normalise_data(y, size_y);
-    }
-
-    /* Generate the output file name */
-    generate_file_name(conv_conf.ofile, conv_conf.input_info, conv_conf.input_flag);
-
-    if (sf_info_x.format != 0) {
-        sf_info_y = sf_info_x;
-    } else if (sf_info_h.format != 0) {
-        sf_info_y = sf_info_h;
-    }
-
-    /* Output to specified buffer */
-    conv_conf.outp(&conv_conf, &sf_info_y, y);
+    /* Normalise, name, and output the result */
+    CHECK_ERR(write_output(&conv_conf, &sf_info_x, &sf_info_h, y));
 
     return 0;
 }
@@ -0,0 +1,431 @@
+#include "unity/unity.h"
+#include "unity/unity_internals.h"
+#include "../conv.h"
+#include <unistd.h>
+#include <sys/stat.h>
+
+#define TEST_TOLERANCE 1e-12
+
+void setUp() {}
+
+void tearDown() {
+    fflush(stdout);
+}
+
+void split(char* cmd, char** argv, int* argc) {
+    char* token = strtok(cmd," ");
+    *argc = 0;
+    while(token != NULL) {
+        argv[*argc] = token;
+        token = strtok(NULL," ");
+        *argc = *argc + 1;
+    }
+}
+
+/* Same sequence on every run */
+double random_sample(uint32_t* seed) {
+    *seed = *seed * 1664525u + 1013904223u;
+
+    return (*seed >> 8) / 16777216.0 - 0.5;
+}
+
+void write_wav(const char* path, size_t frames, int channels, int subtype, uint32_t seed) {
+    SF_INFO sf_info = {
+        .samplerate = 48000,
+        .channels = channels,
+        .format = SF_FORMAT_WAV | subtype,
+    };
+    double* x = malloc(frames * channels * sizeof(double));
+
+    for (size_t i = 0; i < frames * channels; i++) {
+        x[i] = random_sample(&seed);
+    }
+
+    SNDFILE* file = sf_open(path, SFM_WRITE, &sf_info);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(frames, sf_writef_double(file, x, frames));
+    sf_close(file);
+    free(x);
+}
+
+void write_text_file(const char* path, const char* text) {
+    FILE* file = fopen(path, "w");
+
+    TEST_ASSERT_NOT_NULL(file);
+    fputs(text, file);
+    fclose(file);
+}
+
+/* The in-memory path of main, with y[n] left for the test to check */
+int run_conv(const char* cmd, conv_config_t* conv_conf, double** y) {
+    SF_INFO sf_info_x = {0};
+    SF_INFO sf_info_h = {0};
+    double* x = NULL;
+    double* h = NULL;
+    char line[MAX_STR * 4];
+    char* argv[40];
+    int argc;
+
+    snprintf(line, sizeof(line), "first %s -q", cmd);
+    split(line, argv, &argc);
+
+    memset(conv_conf, 0, sizeof(conv_config_t));
+    set_defaults(conv_conf);
+    if (get_options(argc, argv, conv_conf) || read_inputs(conv_conf, &sf_info_x, &sf_info_h, &x, &h)) {
+        return 1;
+    }
+    if (conv_conf->schedule.count && read_ir_schedule(conv_conf)) {
+        return 1;
+    }
+
+    const size_t size_x = conv_conf->input_info[X_INDEX].data_samples;
+    const size_t size_h = get_ir_frames(conv_conf);
+
+    conv_conf->total_samples = size_x + size_h - 1;
+    conv_conf->channels = conv_conf->input_info[X_INDEX].channels > get_ir_channels(conv_conf) ? conv_conf->input_info[X_INDEX].channels : get_ir_channels(conv_conf);
+    if (conv_conf->complex_flag && check_complex_channels(conv_conf)) {
+        return 1;
+    }
+    if (conv_conf->matrix_flag && set_matrix_output(conv_conf, h)) {
+        return 1;
+    }
+    if (conv_conf->conv_fcn == NULL) {
+        conv_conf->conv_fcn = autoset_engine(conv_conf, size_x, size_h);
+    }
+
+    *y = calloc(conv_conf->total_samples * conv_conf->channels, sizeof(double));
+    TEST_ASSERT_NOT_NULL(*y);
+
+    int ret = conv_conf->conv_fcn(conv_conf, x, h, *y);
+
+    release_input(&conv_conf->input_info[X_INDEX], x);
+    release_input(&conv_conf->input_info[H_INDEX], h);
+    return ret;
+}
+
+/* Largest difference from the direct sum, relative to the peak of y[n] */
+void check_against_direct(const char* inputs, const char* options) {
+    conv_config_t conv_conf;
+    conv_config_t ref_conf;
+    double* y = NULL;
+    double* y_ref = NULL;
+    char cmd[MAX_STR * 2];
+    double peak = 0.0;
+    double error = 0.0;
+
+    snprintf(cmd, sizeof(cmd), "%s -e direct", inputs);
+    TEST_ASSERT_EQUAL_INT(0, run_conv(cmd, &ref_conf, &y_ref));
+    snprintf(cmd, sizeof(cmd), "%s %s", inputs, options);
+    TEST_ASSERT_EQUAL_INT(0, run_conv(cmd, &conv_conf, &y));
+
+    TEST_ASSERT_EQUAL_INT(ref_conf.total_samples, conv_conf.total_samples);
+    TEST_ASSERT_EQUAL_INT(ref_conf.channels, conv_conf.channels);
+    for (size_t i = 0; i < ref_conf.total_samples * ref_conf.channels; i++) {
+        peak = fmax(peak, fabs(y_ref[i]));
+        error = fmax(error, fabs(y[i] - y_ref[i]));
+    }
+    TEST_ASSERT_TRUE(peak > 0.0);
+    TEST_ASSERT_DOUBLE_WITHIN(TEST_TOLERANCE, 0.0, error / peak);
+
+    free(y);
+    free(y_ref);
+}
+
+void test_inputs() {
+    mkdir("build/inputs", 0777);
+    write_wav("build/inputs/x-mono.wav", 3000, 1, SF_FORMAT_DOUBLE, 1);
+    write_wav("build/inputs/x-stereo.wav", 3000, 2, SF_FORMAT_DOUBLE, 2);
+    write_wav("build/inputs/h-mono.wav", 200, 1, SF_FORMAT_DOUBLE, 3);
+    write_wav("build/inputs/h-stereo.wav", 300, 2, SF_FORMAT_DOUBLE, 4);
+    write_wav("build/inputs/h-3ch.wav", 250, 3, SF_FORMAT_DOUBLE, 5);
+    write_wav("build/inputs/h-4ch.wav", 150, 4, SF_FORMAT_DOUBLE, 6);
+    write_wav("build/inputs/x-s16.wav", 2000, 2, SF_FORMAT_PCM_16, 7);
+    write_wav("build/inputs/h-s16.wav", 40, 1, SF_FORMAT_PCM_16, 8);
+    write_wav("build/inputs/x-long.wav", 200000, 2, SF_FORMAT_DOUBLE, 9);
+}
+
+void test_conv_fft() {
+    /* Channel pairs share one complex transform, odd channel counts leave one real channel on its own */
+    check_against_direct("build/inputs/x-mono.wav build/inputs/h-mono.wav", "-e fft");
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-mono.wav", "-e fft");
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-stereo.wav", "-e fft");
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-3ch.wav", "-e fft");
+    check_against_direct("build/inputs/x-mono.wav build/inputs/h-4ch.wav", "-e fft");
+}
+
+void test_conv_fft_transformed() {
+    conv_config_t ref_conf;
+    conv_config_t conv_conf;
+    double* y_ref = NULL;
+    SF_INFO sf_info_x = {0};
+    SF_INFO sf_info_h = {0};
+    double* x = NULL;
+    double* h = NULL;
+    spectra_t X = {0};
+    char cmd[] = "first build/inputs/x-stereo.wav build/inputs/h-4ch.wav -q";
+    char* argv[40];
+    int argc;
+
+    TEST_ASSERT_EQUAL_INT(0, run_conv("build/inputs/x-stereo.wav build/inputs/h-4ch.wav -e direct", &ref_conf, &y_ref));
+
+    /* The batch of h[n] inputs transforms x[n] once for the output channels and reuses it */
+    split(cmd, argv, &argc);
+    set_defaults(&conv_conf);
+    TEST_ASSERT_EQUAL_INT(0, get_options(argc, argv, &conv_conf));
+    TEST_ASSERT_EQUAL_INT(0, read_inputs(&conv_conf, &sf_info_x, &sf_info_h, &x, &h));
+    conv_conf.total_samples = ref_conf.total_samples;
+    conv_conf.channels = ref_conf.channels;
+
+    fft_plan_t* plan = create_fft_plan(nextpow2(conv_conf.total_samples));
+    TEST_ASSERT_NOT_NULL(plan);
+    TEST_ASSERT_EQUAL_INT(0, transform_channels(plan, get_input_samples(&conv_conf.input_info[X_INDEX], x), conv_conf.input_info[X_INDEX].data_samples, 2, conv_conf.channels, &X));
+    TEST_ASSERT_EQUAL_INT(2, X.pairs);
+    TEST_ASSERT_EQUAL_INT(4, X.channels);
+
+    double* y = calloc(conv_conf.total_samples * conv_conf.channels, sizeof(double));
+    TEST_ASSERT_EQUAL_INT(0, conv_fft_transformed(&conv_conf, plan, &X, h, y));
+    for (size_t i = 0; i < conv_conf.total_samples * conv_conf.channels; i++) {
+        TEST_ASSERT_DOUBLE_WITHIN(TEST_TOLERANCE, y_ref[i], y[i]);
+    }
+
+    free_spectra(&X);
+    destroy_fft_plan(plan);
+    release_input(&conv_conf.input_info[X_INDEX], x);
+    release_input(&conv_conf.input_info[H_INDEX], h);
+    free(y);
+    free(y_ref);
+}
+
+void test_conv_block() {
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-mono.wav", "-e block");
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-3ch.wav", "-e block --block-size 64");
+    check_against_direct("build/inputs/x-mono.wav build/inputs/h-4ch.wav", "-e block --block-size 128");
+}
+
+void test_ir_cache() {
+    conv_config_t conv_conf;
+    double* y = NULL;
+
+    /* The first run stores the spectra and the second one loads them */
+    mkdir("build/cache", 0777);
+    TEST_ASSERT_EQUAL_INT(0, run_conv("build/inputs/x-stereo.wav build/inputs/h-3ch.wav --cache-dir build/cache", &conv_conf, &y));
+    TEST_ASSERT_EQUAL_PTR(conv_block, conv_conf.conv_fcn);
+    free(y);
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-3ch.wav", "--cache-dir build/cache");
+}
+
+void test_ir_schedule() {
+    /* Switching to the same h[n] does not change y[n], wherever the crossfade falls */
+    write_text_file("build/inputs/schedule.txt", "0.01 build/inputs/h-stereo.wav\n0.03 build/inputs/h-stereo.wav\n");
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-stereo.wav", "--ir-schedule build/inputs/schedule.txt --block-size 64");
+    check_against_direct("build/inputs/x-stereo.wav build/inputs/h-stereo.wav", "--ir-schedule build/inputs/schedule.txt --crossfade 0");
+}
+
+void test_conv_direct_s16() {
+    conv_config_t conv_conf;
+    double* y = NULL;
+
+    TEST_ASSERT_EQUAL_INT(0, run_conv("build/inputs/x-s16.wav build/inputs/h-s16.wav", &conv_conf, &y));
+    TEST_ASSERT_EQUAL_PTR(conv_direct_s16, conv_conf.conv_fcn);
+    free(y);
+
+    /* Integer products are exact, only the final scaling rounds */
+    check_against_direct("build/inputs/x-s16.wav build/inputs/h-s16.wav", "-e direct-s16");
+}
+
+void test_conv_out_of_core() {
+    conv_config_t ref_conf;
+    conv_config_t conv_conf;
+    double* y_ref = NULL;
+    SF_INFO sf_info = {0};
+    char cmd[] = "first build/inputs/x-long.wav build/inputs/h-stereo.wav --mem-limit 1 -o build/inputs/ooc.wav -q";
+    char* argv[40];
+    int argc;
+
+    TEST_ASSERT_EQUAL_INT(0, run_conv("build/inputs/x-long.wav build/inputs/h-stereo.wav -e fft", &ref_conf, &y_ref));
+
+    /* 1 MB holds only a part of the 6.4 MB x[n], so it is convolved in chunks */
+    split(cmd, argv, &argc);
+    set_defaults(&conv_conf);
+    TEST_ASSERT_EQUAL_INT(0, get_options(argc, argv, &conv_conf));
+    TEST_ASSERT_EQUAL_INT(0, conv_out_of_core(&conv_conf));
+
+    SNDFILE* file = sf_open("build/inputs/ooc.wav", SFM_READ, &sf_info);
+    TEST_ASSERT_NOT_NULL(file);
+    TEST_ASSERT_EQUAL_INT(ref_conf.total_samples, sf_info.frames);
+    TEST_ASSERT_EQUAL_INT(ref_conf.channels, sf_info.channels);
+
+    double* y = malloc(sf_info.frames * sf_info.channels * sizeof(double));
+    TEST_ASSERT_EQUAL_INT(sf_info.frames, sf_readf_double(file, y, sf_info.frames));
+    for (size_t i = 0; i < ref_conf.total_samples * ref_conf.channels; i++) {
+        TEST_ASSERT_DOUBLE_WITHIN(TEST_TOLERANCE, y_ref[i], y[i]);
+    }
+
+    sf_close(file);
+    free(y);
+    free(y_ref);
+}
+
+void test_conv_complex() {
+    write_text_file("build/inputs/x-iq.csv", "0.5,-0.25\n1,0\n-0.75,0.5\n0.125,1\n0,-1\n0.25,0.25\n");
+    write_text_file("build/inputs/h-iq.csv", "1,1\n-0.5,0.25\n0.75,0\n");
+
+    check_against_direct("build/inputs/x-iq.csv build/inputs/h-iq.csv --complex", "-e fft");
+}
+
+void test_conv_2d() {
+    conv_config_t conv_conf;
+    double* y = NULL;
+
+    write_text_file("build/inputs/x-matrix.csv", "1,2,3,4\n-1,0.5,2,1\n3,-2,0,1\n0.25,1,-1,2\n1,1,1,-3\n");
+    write_text_file("build/inputs/h-matrix.csv", "1,-2,1\n0.5,0.25,-1\n");
+    write_text_file("build/inputs/h-rank1.csv", "1,2,1\n2,4,2\n-1,-2,-1\n");
+
+    check_against_direct("build/inputs/x-matrix.csv build/inputs/h-matrix.csv --2d", "-e fft");
+    check_against_direct("build/inputs/x-matrix.csv build/inputs/h-rank1.csv --2d", "-e fft");
+    check_against_direct("build/inputs/x-matrix.csv build/inputs/h-rank1.csv --2d", "-e separable");
+
+    /* Rank-1 kernels are split into two 1-D passes automatically */
+    TEST_ASSERT_EQUAL_INT(0, run_conv("build/inputs/x-matrix.csv build/inputs/h-rank1.csv --2d", &conv_conf, &y));
+    TEST_ASSERT_EQUAL_PTR(conv_separable_2d, conv_conf.conv_fcn);
+    TEST_ASSERT_EQUAL_INT(6, conv_conf.columns);
+    free(y);
+
+    TEST_ASSERT_EQUAL_INT(0, run_conv("build/inputs/x-matrix.csv build/inputs/h-matrix.csv --2d", &conv_conf, &y));
+    TEST_ASSERT_NOT_EQUAL(conv_separable_2d, conv_conf.conv_fcn);
+    free(y);
+
+    /* Nearly rank-1 kernels keep the exact engines, and whole numbers are not taken as rounded even when asked for */
+    write_text_file("build/inputs/h-near.csv", "1000,1000\n1000,1001\n");
+    check_against_direct("build/inputs/x-matrix.csv build/inputs/h-near.csv --2d", "");
+    TEST_ASSERT_EQUAL_INT(0, run_conv("build/inputs/x-matrix.csv build/inputs/h-near.csv --2d", &conv_conf, &y));
+    TEST_ASSERT_NOT_EQUAL(conv_separable_2d, conv_conf.conv_fcn);
+    free(y);
+    TEST_ASSERT_EQUAL_INT(1, run_conv("build/inputs/x-matrix.csv build/inputs/h-near.csv --2d -e separable", &conv_conf, &y));
+    free(y);
+}
+
+void test_factor_separable() {
+    const double exact[] = {1.0, 2.0, 1.0, 2.0, 4.0, 2.0, -1.0, -2.0, -1.0};
+    const double near[] = {1.0, 1.0, 1.0, 1.0 + 1e-9};
+    const double whole[] = {1000.0, 1000.0, 1000.0, 1001.0};
+    const double gaussian_1d[] = {0.054489, 0.244201, 0.402620, 0.244201, 0.054489};
+    double gaussian[25];
+    double u[5];
+    double v[5];
+
+    /* A Gaussian written to 6 decimals is rank-1 only up to that rounding */
+    for (size_t i = 0; i < 5; i++) {
+        for (size_t j = 0; j < 5; j++) {
+            gaussian[i * 5 + j] = round(gaussian_1d[i] * gaussian_1d[j] * 1e6) / 1e6;
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(1, factor_separable(exact, 3, 3, u, v, 0));
+    for (size_t i = 0; i < 3; i++) {
+        for (size_t j = 0; j < 3; j++) {
+            TEST_ASSERT_EQUAL_DOUBLE(exact[i * 3 + j], u[i] * v[j]);
+        }
+    }
+
+    TEST_ASSERT_EQUAL_INT(0, factor_separable(near, 2, 2, u, v, 0));
+    TEST_ASSERT_EQUAL_INT(0, factor_separable(near, 2, 2, u, v, 1));
+    TEST_ASSERT_EQUAL_INT(0, factor_separable(whole, 2, 2, u, v, 0));
+    TEST_ASSERT_EQUAL_INT(0, factor_separable(whole, 2, 2, u, v, 1));
+    TEST_ASSERT_EQUAL_INT(0, factor_separable(gaussian, 5, 5, u, v, 0));
+    TEST_ASSERT_EQUAL_INT(1, factor_separable(gaussian, 5, 5, u, v, 1));
+}
+
+void test_parse_csv_data() {
+    const size_t count = 3 * CSV_CHUNK_MIN_BYTES / 8;
+    char* text = malloc(count * 16);
+    size_t size = 0;
+    size_t samples_single = 0;
+    size_t samples_parallel = 0;
+    double* x_single = NULL;
+    double* x_parallel = NULL;
+    uint32_t seed = 10;
+
+    /* Mixed separators and line endings */
+    char small[] = "1.5, -2\r\n3e-1\n\n4,5.25 ,6\n";
+    TEST_ASSERT_EQUAL_INT(0, parse_csv_data(small, strlen(small), &x_single, &samples_single, "small", 1));
+    TEST_ASSERT_EQUAL_INT(6, samples_single);
+    TEST_ASSERT_EQUAL_DOUBLE(1.5, x_single[0]);
+    TEST_ASSERT_EQUAL_DOUBLE(-2.0, x_single[1]);
+    TEST_ASSERT_EQUAL_DOUBLE(0.3, x_single[2]);
+    TEST_ASSERT_EQUAL_DOUBLE(6.0, x_single[5]);
+    free(x_single);
+
+    /* Chunks split at any byte give the values of a single pass */
+    for (size_t i = 0; i < count; i++) {
+        size += sprintf(text + size, i % 4 == 3 ? "%.6f\n" : "%.6f,", random_sample(&seed));
+    }
+    TEST_ASSERT_EQUAL_INT(0, parse_csv_data(text, size, &x_single, &samples_single, "single", 1));
+    TEST_ASSERT_EQUAL_INT(0, parse_csv_data(text, size, &x_parallel, &samples_parallel, "parallel", 4));
+    TEST_ASSERT_EQUAL_INT(count, samples_single);
+    TEST_ASSERT_EQUAL_INT(count, samples_parallel);
+    TEST_ASSERT_EQUAL_MEMORY(x_single, x_parallel, count * sizeof(double));
+
+    free(text);
+    free(x_single);
+    free(x_parallel);
+}
+
+void test_quantize() {
+    const double x[] = {1.0, -1.0, 0.5, -0.5, 1.5, -1.5, 0.0, 1.0 / 32767.0};
+    const double noise[8] = {0};
+    int16_t out[8];
+    int32_t out_int[8];
+
+    /* Full scale is the largest sample, as libsndfile converts doubles */
+    quantizer_t* quantizer = create_quantizer(SF_FORMAT_PCM_16, 0);
+    TEST_ASSERT_NOT_NULL(quantizer);
+    TEST_ASSERT_EQUAL_DOUBLE(32767.0, quantizer->gain);
+    TEST_ASSERT_EQUAL_INT(2, quantize_short(x, 8, quantizer->gain, noise, out));
+    TEST_ASSERT_EQUAL_INT(32767, out[0]);
+    TEST_ASSERT_EQUAL_INT(-32767, out[1]);
+    TEST_ASSERT_EQUAL_INT(16384, out[2]);
+    TEST_ASSERT_EQUAL_INT(-16384, out[3]);
+    TEST_ASSERT_EQUAL_INT(32767, out[4]);
+    TEST_ASSERT_EQUAL_INT(-32768, out[5]);
+    TEST_ASSERT_EQUAL_INT(0, out[6]);
+    TEST_ASSERT_EQUAL_INT(1, out[7]);
+    destroy_quantizer(quantizer);
+
+    /* Streams keep the full scale of the clipping conversion */
+    quantizer = create_quantizer(SF_FORMAT_PCM_16, 1);
+    TEST_ASSERT_EQUAL_DOUBLE(32768.0, quantizer->gain);
+    destroy_quantizer(quantizer);
+
+    /* 24-bit samples go to libsndfile in the top bits of an int */
+    quantizer = create_quantizer(SF_FORMAT_PCM_24, 0);
+    TEST_ASSERT_EQUAL_INT(2, quantize_int(x, 8, quantizer->gain, noise, quantizer->min, quantizer->max, quantizer->step, out_int));
+    TEST_ASSERT_EQUAL_INT(0x7FFFFF * 256, out_int[0]);
+    TEST_ASSERT_EQUAL_INT(-0x7FFFFF * 256, out_int[1]);
+    TEST_ASSERT_EQUAL_INT(-0x800000 * 256, out_int[5]);
+    destroy_quantizer(quantizer);
+
+    /* Floats are not quantized */
+    quantizer = create_quantizer(SF_FORMAT_FLOAT, 0);
+    TEST_ASSERT_EQUAL_INT(0, quantizer->format);
+    destroy_quantizer(quantizer);
+}
+
+int main() {
+    UNITY_BEGIN();
+    RUN_TEST(test_inputs);
+    RUN_TEST(test_conv_fft);
+    RUN_TEST(test_conv_fft_transformed);
+    RUN_TEST(test_conv_block);
+    RUN_TEST(test_ir_cache);
+    RUN_TEST(test_ir_schedule);
+    RUN_TEST(test_conv_direct_s16);
+    RUN_TEST(test_conv_out_of_core);
+    RUN_TEST(test_conv_complex);
+    RUN_TEST(test_conv_2d);
+    RUN_TEST(test_factor_separable);
+    RUN_TEST(test_parse_csv_data);
+    RUN_TEST(test_quantize);
+
+    return UNITY_END();
+}